@@ -20,6 +20,8 @@
 #include "PoliceShip.h"
 #include "Objects.h"
 #include "Shapes.h"
+#include "SphereMesh.h"
+#include "Profiler.h"
 #include "SpaceStation.h"
 #include "Star.h"
 #include "Planet.h"
@@ -28,6 +30,10 @@
 #include "PlayerObject.h"
 #include "FileAccess.h"
 #include "FrameCounter.h"
+#include "FrameCapture.h"
+#include "GlobalParameters.h"
+#include "InstanceRenderer.h"
+#include "AssetLoader.h"
 
 using namespace std;
 
@@ -48,6 +54,8 @@ consoleCommand App::table[] = {
   {"help",6},
   {"devmode", 7},
   {"switchColors",8},
+  {"exportTrace",9},
+  {"record",10},
   {NULL, -1}
 };
 
@@ -80,6 +88,8 @@ App::App( const char  * className ) : OpenGLApplication( className ) {
   fptr[6] = &App::showHelp;
   fptr[7] = &App::devMode;
   fptr[8] = &App::switchColors;
+  fptr[9] = &App::exportTrace;
+  fptr[10] = &App::record;
 
   zoomFactor = 1;
 
@@ -89,6 +99,7 @@ App::App( const char  * className ) : OpenGLApplication( className ) {
   m_inputmode = false;
   m_showFrameRate = m_showFrameTime = m_showResolution = true;
   m_showSpeed = false;
+  m_showZones = false;
   m_switchColors = false;
   //infoOutputLine; // does not need to be initialized, is set to 0 at beginning of every frame
 
@@ -98,6 +109,8 @@ App::App( const char  * className ) : OpenGLApplication( className ) {
 
   // game status
   laserActive = false;
+  laserLength = LASER_RANGE;
+  simulationAccumulator = 0;
   inStation = false;
   gameOver = false;
 
@@ -135,10 +148,13 @@ void App::deinitialize() {
 
   delete mouse;
   delete frustum;
+  delete shipRenderer;
   delete con;
   delete ti;
   delete tf2;
   delete tf;
+  Shapes::release(); // the display lists belong to the rendering context of the window
+  SphereMesh::release();
 }
 
 /**
@@ -169,12 +185,18 @@ void App::draw() {
 case currentSystem:
   {
     getWindow()->showMousePointer( false );
+    // the objects are drawn between the last two simulation steps
+    World::getWorld()->interpolateStates( (float)simulationAccumulator / SIMULATION_STEP );
+    frustum->setFrustumInformation( getWindow()->getFrustum() );
+    frustum->update( player );
+
     unsigned int oldHeight = getWindow()->getHeight();
     unsigned int oldWidth = getWindow()->getWidth();
     getWindow()->setHeight( 128 );
     getWindow()->setWidth( 128 );
     getWindow()->reshape();
     firstDraw = true;
+    Profiler::getProfiler()->beginZone( "rear view" );
     drawCurrentSystem();
 
 
@@ -186,12 +208,14 @@ case currentSystem:
     loader->load( image, getWindow()->getWidth(), getWindow()->getHeight(), 3);
     Textures::getTextures()->loadTexture( rearview, loader );
     delete[] image;
+    Profiler::getProfiler()->endZone();
 
     getWindow()->setHeight( oldHeight );
     getWindow()->setWidth( oldWidth );
     getWindow()->reshape();
     firstDraw = false;
     drawCurrentSystem();
+    World::getWorld()->restoreStates();
   }
   break;
 case localSystems:
@@ -217,6 +241,7 @@ case localSystems:
           player = World::getWorld()->getPlayer();
           // reload textures
           loadSystemTextures();
+          prefetchLocalSystemTextures();
           getWindow()->showMousePointer( false );
           setScreen( systemInfo );
         }
@@ -364,10 +389,17 @@ case loadLevel:
 void App::drawCurrentSystem() {
   if( !firstDraw ) {
     // send some information lines to the print-on-display vector
+    Profiler *profiler = Profiler::getProfiler();
     if( m_showFrameTime )
-      printInfoLine("Frametime:%3.2f ms", getFrameCounter()->getFrameTimeAverage());
+      printInfoLine("Frametime:%3.2f ms (p50 %3.2f, p95 %3.2f, p99 %3.2f)", getFrameCounter()->getFrameTimeAverage(),
+        profiler->getFrameTimePercentile( 50 ), profiler->getFrameTimePercentile( 95 ), profiler->getFrameTimePercentile( 99 ) );
     if( m_showFrameRate )
       printInfoLine("Framerate:%d fps", getFrameCounter()->getFrameRateAverage());
+    if( m_showZones ) {
+      profiler->getZoneTimes( zoneTimes );
+      for( unsigned int i=0; i < zoneTimes.size(); i++ )
+        printInfoLine("%*s%s: %3.2f ms", 2*zoneTimes[i].depth, "", zoneTimes[i].name, zoneTimes[i].milliseconds);
+    }
     if( m_showResolution )
       printInfoLine("Screensize: %dx%d", getWindow()->getWidth(), getWindow()->getHeight());
     if( m_showSpeed ) {
@@ -387,104 +419,135 @@ void App::drawCurrentSystem() {
 
   // draw the skysphere. thus the z-buffer is deactivated, so that the skysphere appears to be in the background
   // fast mode is already activated (at least, it should be ;)
+  Profiler *profiler = Profiler::getProfiler();
+  profiler->beginZone( "sky" );
   fastMode();
   glPushMatrix();
   glColor4f( 1.0f, 1.0f, 1.0f, 1.0f );
   glTranslatef( player->getPos().x, player->getPos().y, player->getPos().z );// move sphere with viewer
   glRotatef( 90, 1, 0, 0 );
    Textures::getTextures()->bindTexture( background );
-  gluSphere( quadObj, 100, 32, 32 );
+  SphereMesh::draw( 100, 0 );
   glPopMatrix();
+  profiler->endZone();
 
   // activate full mode in order to draw the main scene. the z-buffer can now be cleared
   // render main scene
   fullMode();
   glClear( GL_DEPTH_BUFFER_BIT );
+  World::getWorld()->getStar()->setLight();// place the light, even if the star itself is culled
 
-  vector<GraphicsObject*> *objects = World::getWorld()->getGraphicObjects();
-  for( unsigned int i=0; i < objects->size(); i++ ) {
-    CullingLocation res = getFrustum()->isSphereInFrustum( objects->at(i)->getPos(), objects->at(i)->getRadius() );
+  profiler->beginZone( "planets and station" );
+  const vector<GraphicsObject*> &objects = World::getWorld()->getGraphicObjects();
+  SphereMesh::setFrustum( getFrustum() ); // planets far away are drawn with less triangles
+  for( unsigned int i=0; i < objects.size(); i++ ) {
+    CullingLocation res = getFrustum()->isSphereInFrustum( objects[i]->getPos(), objects[i]->getRadius() );
+    if( player->isRearView() )
+      res = inside;
+    if( res != outside )
+      objects[i]->draw();
+  }
+  SphereMesh::setFrustum( 0 );
+  profiler->endZone();
+
+  // draw the visible ships, all ships with the same model at once
+  profiler->beginZone( "culling" );
+  const vector<SpaceShip*> &ships = World::getWorld()->getSpaceShips();
+  shipRenderer->clear();
+  for( unsigned int i=0; i < ships.size(); i++ ) {
+    CullingLocation res = getFrustum()->isSphereInFrustum( ships[i]->getPos(), ships[i]->getRadius() );
+    if( player->isRearView() )
+      res = inside;
+    if( res != outside )
+      shipRenderer->add( ships[i] );
+  }
+  profiler->endZone();
+  profiler->beginZone( "ships" );
+  shipRenderer->draw();
+  profiler->endZone();
+
+  // draw the lasers of all visible ships that are shooting
+  profiler->beginZone( "lasers" );
+  for( unsigned int i=0; i < ships.size(); i++ ) {
+    SpaceShip* ship = ships[i];
+    if( !ship->isShooting() )
+      continue;
+    CullingLocation res = getFrustum()->isSphereInFrustum( ship->getPos(), ship->getRadius() );
     if( player->isRearView() )
       res = inside;
     if( res != outside ) {
-      objects->at(i)->draw();
-      SpaceShip* ship = dynamic_cast<SpaceShip*>( objects->at(i) );
-      if( ship ) {
-        glDisable( GL_CULL_FACE );
-        if( ship->isShooting() ) {
-            glDisable( GL_LIGHTING ); // deactivate lighting for the laser
-            glDisable( GL_LIGHT0 ); // star is deactivated (is this really necessary?)
-            glEnable( GL_BLEND ); // blending enabled, as the laser is transparent
-            Textures::getTextures()->bindTexture( laser );
-            glColor3fv( colorRed );
-            Vector3 shootVector = ship->getPos() - player->getPos();
-            shootVector.normalize();
-
-            // new calculation
-            Vector3 p = ship->getPos() - player->getPos();  // vector to the ship
-            Vector3 v = player->getView();
-            v.normalize();
-
-            Vector3 aimFrom = ship->getPos();
-            Vector3 aimTo = player->getPos() + player->getView()*20;
-
-            Vector3 sproj = player->getView() * ship->getPos().innerProduct( player->getView() );
-            Vector3 v2 = player->getRight();
-            v2.normalize();
-            Vector3 v3 = ship->getPos() - sproj;
-            v3.normalize();
-
-            float cosval = v2.innerProduct( v3 );
-            float winkel = acos(cosval) / ANGLE2DEG;
-
-            if(winkel > 90)
-            winkel = 180 - winkel;
-            Vector3 absbla = player->getUp() * ((90.0-winkel)/90.0) + player->getRight() * (winkel/90.0);
-            Vector3 absbla2 = player->getRight() * ((90.0-winkel)/90.0) + player->getUp() * (winkel/90.0);
-            absbla.normalize();
-
-            Vector3 aimToLeft = aimTo + absbla * -5.0f;
-            Vector3 aimToRight = aimTo + absbla * 5.0f;
-            Vector3 aimFromLeft = aimFrom + absbla * -5;
-            Vector3 aimFromRight = aimFrom + absbla * 5;
-
-            glEnable( GL_BLEND );
-            glBegin( GL_QUADS );
-              glTexCoord2f( 0, 1 );
-              glVertex3f( aimFromLeft.x, aimFromLeft.y, aimFromLeft.z );
-              glTexCoord2f( 0, 0 );
-              glVertex3f( aimToLeft.x, aimToLeft.y, aimToLeft.z );
-              glTexCoord2f( 1, 0 );
-              glVertex3f( aimToRight.x, aimToRight.y, aimToRight.z );
-              glTexCoord2f( 1, 1 );
-              glVertex3f( aimFromRight.x, aimFromRight.y, aimFromRight.z );
-            //if( frustum->isInRightHalf( ship->getPos() ) && frustum->isInUpperHalf( ship->getPos() ) ) {
-              Plane aimPlane = Plane(aimToLeft, aimToRight, aimFromRight);
-              Vector3 absblaOrtho = aimPlane.getNormal();
-              aimToLeft = aimTo + absblaOrtho * -5.0f;
-              aimToRight = aimTo + absblaOrtho * 5.0f;
-              aimFromLeft = aimFrom + absblaOrtho * -5;
-              aimFromRight = aimFrom + absblaOrtho * 5;
-            //}
-              glTexCoord2f( 0, 1 );
-              glVertex3f( aimFromLeft.x, aimFromLeft.y, aimFromLeft.z );
-              glTexCoord2f( 0, 0 );
-              glVertex3f( aimToLeft.x, aimToLeft.y, aimToLeft.z );
-              glTexCoord2f( 1, 0 );
-              glVertex3f( aimToRight.x, aimToRight.y, aimToRight.z );
-              glTexCoord2f( 1, 1 );
-              glVertex3f( aimFromRight.x, aimFromRight.y, aimFromRight.z );
-            glEnd();
-            glDisable( GL_BLEND );
-            glEnable( GL_TEXTURE_2D );
-            fullMode();
-            glEnable( GL_LIGHTING );
-        }
-        glEnable( GL_CULL_FACE );
-      }
+      glDisable( GL_CULL_FACE );
+      glDisable( GL_LIGHTING ); // deactivate lighting for the laser
+      glDisable( GL_LIGHT0 ); // star is deactivated (is this really necessary?)
+      glEnable( GL_BLEND ); // blending enabled, as the laser is transparent
+      Textures::getTextures()->bindTexture( laser );
+      glColor3fv( colorRed );
+      Vector3 shootVector = ship->getPos() - player->getPos();
+      shootVector.normalize();
+
+      // new calculation
+      Vector3 p = ship->getPos() - player->getPos();  // vector to the ship
+      Vector3 v = player->getView();
+      v.normalize();
+
+      Vector3 aimFrom = ship->getPos();
+      Vector3 aimTo = player->getPos() + player->getView()*20;
+
+      Vector3 sproj = player->getView() * ship->getPos().innerProduct( player->getView() );
+      Vector3 v2 = player->getRight();
+      v2.normalize();
+      Vector3 v3 = ship->getPos() - sproj;
+      v3.normalize();
+
+      float cosval = v2.innerProduct( v3 );
+      float winkel = acos(cosval) / ANGLE2DEG;
+
+      if(winkel > 90)
+      winkel = 180 - winkel;
+      Vector3 absbla = player->getUp() * ((90.0-winkel)/90.0) + player->getRight() * (winkel/90.0);
+      Vector3 absbla2 = player->getRight() * ((90.0-winkel)/90.0) + player->getUp() * (winkel/90.0);
+      absbla.normalize();
+
+      Vector3 aimToLeft = aimTo + absbla * -5.0f;
+      Vector3 aimToRight = aimTo + absbla * 5.0f;
+      Vector3 aimFromLeft = aimFrom + absbla * -5;
+      Vector3 aimFromRight = aimFrom + absbla * 5;
+
+      glEnable( GL_BLEND );
+      glBegin( GL_QUADS );
+        glTexCoord2f( 0, 1 );
+        glVertex3f( aimFromLeft.x, aimFromLeft.y, aimFromLeft.z );
+        glTexCoord2f( 0, 0 );
+        glVertex3f( aimToLeft.x, aimToLeft.y, aimToLeft.z );
+        glTexCoord2f( 1, 0 );
+        glVertex3f( aimToRight.x, aimToRight.y, aimToRight.z );
+        glTexCoord2f( 1, 1 );
+        glVertex3f( aimFromRight.x, aimFromRight.y, aimFromRight.z );
+      //if( frustum->isInRightHalf( ship->getPos() ) && frustum->isInUpperHalf( ship->getPos() ) ) {
+        Plane aimPlane = Plane(aimToLeft, aimToRight, aimFromRight);
+        Vector3 absblaOrtho = aimPlane.getNormal();
+        aimToLeft = aimTo + absblaOrtho * -5.0f;
+        aimToRight = aimTo + absblaOrtho * 5.0f;
+        aimFromLeft = aimFrom + absblaOrtho * -5;
+        aimFromRight = aimFrom + absblaOrtho * 5;
+      //}
+        glTexCoord2f( 0, 1 );
+        glVertex3f( aimFromLeft.x, aimFromLeft.y, aimFromLeft.z );
+        glTexCoord2f( 0, 0 );
+        glVertex3f( aimToLeft.x, aimToLeft.y, aimToLeft.z );
+        glTexCoord2f( 1, 0 );
+        glVertex3f( aimToRight.x, aimToRight.y, aimToRight.z );
+        glTexCoord2f( 1, 1 );
+        glVertex3f( aimFromRight.x, aimFromRight.y, aimFromRight.z );
+      glEnd();
+      glDisable( GL_BLEND );
+      glEnable( GL_TEXTURE_2D );
+      fullMode();
+      glEnable( GL_LIGHTING );
+      glEnable( GL_CULL_FACE );
     }
   }
-  delete objects;
+  profiler->endZone();
   if( firstDraw ) {
     player->toggleRearView();
     glPopMatrix();
@@ -500,7 +563,7 @@ void App::drawCurrentSystem() {
 
     glPushMatrix();
     glBegin( GL_QUADS );
-    Vector3 target = player->getPos() + player->getView()*4000;
+    Vector3 target = player->getPos() + player->getView()*laserLength;
     Vector3 obenLinks = target + player->getRight()*(-10);
     Vector3 obenRechts = target + player->getRight()*0;
     Vector3 untenLinks = player->getPos() + player->getRight()*(-10) + player->getUp()*(-10);
@@ -537,6 +600,7 @@ void App::drawCurrentSystem() {
   glPopMatrix(); // end of general matrix transformation
 
   // switch to fast mode in order to draw the display elements
+  ProfileZone hudZone( "hud" );
   fastMode();
 
   // set up an orthogonal screen for printing text and drawing the huds
@@ -723,8 +787,10 @@ void App::drawHelp() {
   printInfoLine( "" );
   printInfoLine( "Global console commands (press RETURN, enter command, press RETURN):" );
   printInfoLine( " toggleFullscreen [0|1] - switch to fullscreen or back." );
-  printInfoLine( " showFPS [0|1] - show frames per second or not." );
-  printInfoLine( " showFrameTime [0|1] - show time per frame in milliseconds or not." );
+  printInfoLine( " showFPS [0|1|2] - show frames per second or not, 2 adds the time of each zone of a frame." );
+  printInfoLine( " showFrameTime [0|1|2] - show time per frame in milliseconds or not, 2 adds the time of each zone." );
+  printInfoLine( " exportTrace [file] - save the last frames as chrome trace, default is trace.json." );
+  printInfoLine( " record n - save the next n frames as capture00000.tga and following." );
   printInfoLine( " showSpeed [0|1] - show player speed in absolute values and percent of lightspeed or not." );
   printInfoLine( " showRes [0|1] - show current resolution or not." );
   printInfoLine( " devmode [0|1] - enables developer mode or disables." );
@@ -887,6 +953,9 @@ void App::drawHelpMarketplace() {
   printInfoLine( "- there is an infinite amount of fuel" );
   printInfoLine( "- you cannot buy more fuel than fits into your tank" );
   printInfoLine( "" );
+  printInfoLine( "The best route shows the most profitable jumps from here, with the prices" );
+  printInfoLine( "expected in the other systems and your current cash and holdspace." );
+  printInfoLine( "" );
   printInfoLine( "Rules for selling:" );
   printInfoLine( "- you can only sell goods that you have in your cargo bay" );
   printInfoLine( "- fuel cannot be sold" );
@@ -976,24 +1045,24 @@ void App::drawLocalSystems() {
 
   fullMode();
   for( unsigned int i = 0; i < localSystems->size(); i++ ) {
-    Star *sun = new Star( (localSystems->at(i).pos.x - minPos.x)  * scaleFactor + xOffset,
+    Star sun( (localSystems->at(i).pos.x - minPos.x)  * scaleFactor + xOffset,
       getWindow()->getHeight()+border*0.5-((localSystems->at(i).pos.y - minPos.y)  * scaleFactor + yOffset),
       -20,
       1,
       star
       );
-    sun->setLightColor( 1, 1, 0 );
-    //sun->setTexture(  Textures::getTextures()->getTexture( star_sun ) );
-    //sun->setTexture( World::getWorld()->getSystemStarTexture( localSystems->at(i).systemNumber ) );
-    //sun->setTexture( star );
-    sun->setAxis( 0, 1, 0 );
-    sun->setSpeed( -0.006);
-    sun->setRotateAngle( 0 );
-    sun->setRotateSpeed( 0 );
+    sun.setLightColor( 1, 1, 0 );
+    //sun.setTexture(  Textures::getTextures()->getTexture( star_sun ) );
+    //sun.setTexture( World::getWorld()->getSystemStarTexture( localSystems->at(i).systemNumber ) );
+    //sun.setTexture( star );
+    sun.setAxis( 0, 1, 0 );
+    sun.setSpeed( -0.006);
+    sun.setRotateAngle( 0 );
+    sun.setRotateSpeed( 0 );
+    sun.setDetail( SphereMesh::levelCount - 1 ); // the stars are only a few pixels wide
     glPushAttrib( GL_ALL_ATTRIB_BITS );
-    sun->draw();
+    sun.draw();
     glPopAttrib();
-    delete sun;
   }
   fastMode();
   // print the system names
@@ -1012,6 +1081,7 @@ void App::drawLocalSystems() {
   SystemInfo hoveredSystem;
   hoveredSystem.systemNumber = -1;// intialization to save if a system was hit
   bool alreadyHighlighted = false;
+  tf2->begin(); // all names and the information are drawn at once
   for( unsigned int i=0; i<localSystems->size(); i++) {
     rectPosStart.x = (localSystems->at(i).pos.x - minPos.x)  * scaleFactor + xOffset; // left border
     rectPosEnd.y = getWindow()->getHeight()+border*0.5-((localSystems->at(i).pos.y - minPos.y)  * scaleFactor + yOffset); // lower border ----> print uses lower border as startposition!
@@ -1085,6 +1155,7 @@ void App::drawLocalSystems() {
   if( m_inputmode ) {
     this->ti->print();
   }
+  tf2->flush();
 
   glDisable( GL_BLEND );
 
@@ -1214,6 +1285,7 @@ void App::drawMarketplace() {
   if (mktbuttons.size()>0) 
     rightdrift = (mktbuttons.at(0)->getButtonWidth())*0.75;
 
+  tf2->begin(); // the table is drawn at once, before the buttons
   glColor3fv(colorWhite);
   tf2->print(startx+rightdrift, wheight-headlines*wheight-downdrift, "Price");
 
@@ -1323,6 +1395,20 @@ void App::drawMarketplace() {
   tf2->print(startx-leftdrift, wheight-helplines*wheight,"- Click on item you want to buy / sell.");
   tf2->print(startx-leftdrift, wheight-helplineheight*wheight-helplines*wheight,"- Click on buy / sell to buy / sell one unit of the chosen tradegood.");
 
+  /* print the most profitable route from here  */
+  const TradeRoute & route = World::getWorld()->getBestTradeRoute();
+  if (!route.legs.empty())
+  {
+    std::string systems = World::getWorld()->getSystemName(route.legs[0].from);
+    for (unsigned int i=0; i < route.legs.size(); i++)
+      systems += " - " + World::getWorld()->getSystemName(route.legs[i].to);
+    std::string first = "jump empty";
+    if (route.legs[0].good >= 0)
+      first = "buy " + World::getWorld()->getTradegoodDescription(route.legs[0].good).name;
+    tf2->print(startx-leftdrift, wheight-2*helplineheight*wheight-helplines*wheight,"- Best route: %s, %3.1f CR profit, %s first.",systems.c_str(),route.profit,first.c_str());
+  }
+  tf2->flush();
+
   /* activate buttons if tradegood can be bought / sold  */
 
   for (unsigned int i=0; i < numOfTradegoods; i++)
@@ -1450,20 +1536,18 @@ void App::drawSystemInfo() {
   glRotatef( systemInfoViewAngle2, 0, 0, 1 );
 
 
-  vector<PlanetInfoGraphical> planets;
   SystemInfo sysinfo;
-  if( devmode ) {
+  if( devmode )
     sysinfo = World::getWorld()->getSystemInfo( currentSystemInfoNumber );
-    planets = *World::getWorld()->getSystemPlanets( currentSystemInfoNumber );
-  } else {
+  else
     sysinfo = World::getWorld()->getSystemInfo();
-    planets = *World::getWorld()->getSystemPlanets();
-  }
+  // the planets are only referenced, they are stored by the world
+  const vector<PlanetInfoGraphical> &planets = devmode ? *World::getWorld()->getSystemPlanets( currentSystemInfoNumber ) : *World::getWorld()->getSystemPlanets();
 
   // retrieve size
   float sysSize = 0;
   for( unsigned int i = 0; i < planets.size(); i++) {
-    PlanetInfoGraphical planet = planets[i];
+    const PlanetInfoGraphical &planet = planets[i];
     if( planet.distance > sysSize )
       sysSize = planet.distance;
   }
@@ -1476,31 +1560,30 @@ void App::drawSystemInfo() {
   //scaleFactor *= getWindow()->getAspect();
 
   // star
-  Star *sun = new Star( 0, 0, 0, 2*zoomFactor*10, star );
-  sun->setLightColor( 1, 1, 0);
-  sun->setAxis( 0, 1, 0 );
-  sun->setSpeed( -0.006);
-  sun->setRotateAngle( 0 );
-  sun->setRotateSpeed( 0 );
+  Star sun( 0, 0, 0, 2*zoomFactor*10, star );
+  sun.setLightColor( 1, 1, 0);
+  sun.setAxis( 0, 1, 0 );
+  sun.setSpeed( -0.006);
+  sun.setRotateAngle( 0 );
+  sun.setRotateSpeed( 0 );
   glPushAttrib( GL_ALL_ATTRIB_BITS );
-  sun->draw();
+  sun.draw();
   glPopAttrib();
-  delete sun;
 
   // draw planets
   for( unsigned int i=0; i < planets.size(); i++) {
-    PlanetInfoGraphical planet = planets[i];
-    Planet *erde2 = new Planet( planet.distance  * scaleFactor  * zoomFactor + zoomFactor*10 , 0, 0, 0.7*zoomFactor *10, planet1+i);
+    const PlanetInfoGraphical &planet = planets[i];
+    Planet erde2( planet.distance  * scaleFactor  * zoomFactor + zoomFactor*10 , 0, 0, 0.7*zoomFactor *10, planet1+i);
     // WARNING: this is possibly unsave. it only works if all planets in the texture-slot are in order!
-    //erde2->setTexture( planet1 + i );
-    erde2->setAxis( 0, 1, 0 );
-    erde2->setSpeed( planet.spinningSpeed );
-    erde2->setRotateAngle( planet.rotateAngle );
-    erde2->setRotateSpeed( -1.0  * planet.rotateSpeed  * 100);
-    erde2->setRadiusLineDrawing( true );
-    //erde2->setRotateSpeed ( erde2->getRotateSpeed() );
-    erde2->draw();
-    delete erde2;
+    //erde2.setTexture( planet1 + i );
+    erde2.setAxis( 0, 1, 0 );
+    erde2.setSpeed( planet.spinningSpeed );
+    erde2.setRotateAngle( planet.rotateAngle );
+    erde2.setRotateSpeed( -1.0  * planet.rotateSpeed  * 100);
+    erde2.setRadiusLineDrawing( true );
+    //erde2.setRotateSpeed ( erde2.getRotateSpeed() );
+    erde2.updatePosition( getFrameCounter()->getTime() );
+    erde2.draw();
   }
 
   // restore projection
@@ -1594,14 +1677,18 @@ bool App::initialize() {
   glFlush();
   getWindow()->swap();
 
-  // OpenGL initialization, loading of memory-resistent textures
+  // OpenGL initialization, loading of memory-resistent textures and the models. the files
+  // are decoded in parallel, only the upload is done one after another
   initializeGFX();
-  loadAllNeededTextures();
-
-  // create quadric, will be used for skysphere
-  quadObj = gluNewQuadric();
-  gluQuadricDrawStyle( quadObj, GLU_FILL );
-  gluQuadricTexture( quadObj, GL_TRUE );
+  AssetLoader assets;
+  addNeededTextures( assets );
+  initializeObjects( assets );
+  assets.load();
+  if( devmode ) {
+    printInfoLine( "Loaded %u files using %u threads in %.1f ms.", assets.getAssetCount(), assets.getThreadCount(), assets.getTotalTime() );
+    for( unsigned int i=0; i < assets.getAssetCount(); i++ )
+      printInfoLine( " %s: decoded in %.1f ms, uploaded in %.1f ms", assets.getFilename( i ).c_str(), assets.getDecodeTime( i ), assets.getUploadTime( i ) );
+  }
 
   // load texturefonts
   tf = new TextureFont( font2 );
@@ -1613,13 +1700,14 @@ bool App::initialize() {
   ti = new TextInput( tf2 );
   con = new Console();
   frustum = new Frustum( getWindow()->getFrustum() );
+  shipRenderer = new InstanceRenderer();
   mouse = new MouseHandler();
   laserHeatBar = new HudLoadBar( 0.0f, 100.0f, 0.0f );
   laserHeatBar->setSlopePixel( 10 );
 
   // load game
   loadSystemTextures();
-  initializeObjects();
+  prefetchLocalSystemTextures();
   initMarketplace();
 
   World::getWorld()->initialize();
@@ -1717,18 +1805,19 @@ void App::initMarketplace() {
 }
 
 /**
- * \fn	void App::initializeObjects()
- * \brief	Initializes the 3d objects possible occuring in the world.
+ * \fn	void App::initializeObjects( AssetLoader &assets )
+ * \brief	Adds the 3d objects possible occuring in the world to a loader.
+ * \param	assets	the loader
  */
 
-void App::initializeObjects() {
-  FileAccess::loadObject( adder );
-  FileAccess::loadObject( anaconda );
-  FileAccess::loadObject( ball );
-  FileAccess::loadObject( coriolis );
-  FileAccess::loadObject( missile );
-  FileAccess::loadObject( thargoid );
-  FileAccess::loadObject( tieDroid );
+void App::initializeObjects( AssetLoader &assets ) {
+  assets.addObject( adder );
+  assets.addObject( anaconda );
+  assets.addObject( ball );
+  assets.addObject( coriolis );
+  assets.addObject( missile );
+  assets.addObject( thargoid );
+  assets.addObject( tieDroid );
 }
 
 /**
@@ -1746,6 +1835,10 @@ void App::update( DWORD deltaTime ) {
   }
   // do some update stuff which is generally executed
   getFrameCounter()->update(); // update framecounter to get actual framerate
+  {
+    ProfileZone zone( "texture upload" );
+    Textures::getTextures()->update( TEXTURE_UPLOADS_PER_FRAME ); // create some of the prefetched textures
+  }
   mouse->setMousePosition( getWindow()->getMousePosition());
   mouse->setMouseHovering( false );
 
@@ -1790,31 +1883,8 @@ void App::update( DWORD deltaTime ) {
     }
 
     if( getWindow()->keyPressed( 80 ) ) { // test if p was pressed --> create screenshot
-      // allocate memory
-      unsigned char *image = 0;
-      image = new unsigned char[getWindow()->getWidth() * getWindow()->getHeight() * 3];
-
-      // read the image data
-      glReadPixels( 0, 0, getWindow()->getWidth(), getWindow()->getHeight(), GL_RGB, GL_UNSIGNED_BYTE, image );
-      TextureLoader * loader = new TextureLoaderTGA();
-      loader->load( image, getWindow()->getWidth(), getWindow()->getHeight(), 3);
-      // try to open file
-      char space[32];
-      ifstream file;
-      do {
-        sprintf_s( space, "screenshot%d.tga", rand() );
-        file.open( space, ios::binary );
-      } while( file );
-      file.close();
-      loader->write( space );
-
-      // load as image
-       Textures::getTextures()->loadTexture( rearview, loader );
-      delete[] image;
+      getFrameCapture()->screenshot(); // the frame is read after it is drawn and written in the background
       getWindow()->keyUp( 80 );
-      // does not work, however
-      //TextureLoaderTGA* tga = reinterpret_cast<TextureLoaderTGA*>(loader);
-      //delete tga;
       return;
     }
 
@@ -1829,8 +1899,7 @@ void App::update( DWORD deltaTime ) {
 case credits:
   break;
 case currentSystem:
-  performCurrentSystemInput( deltaTime );
-  break;
+  break; // handled in each simulation step
 case help:
   break;
 case helpEnvironment:
@@ -1856,7 +1925,7 @@ case systemInfo:
 case credits:
   break;
 case currentSystem:
-  updateCurrentSystem( deltaTime );
+  simulateCurrentSystem( deltaTime, !m_inputmode );
   break;
 case help:
   break;
@@ -1879,6 +1948,39 @@ case systemInfo:
   }
 }
 
+/**
+ * \fn	void App::simulateCurrentSystem( DWORD deltaTime, bool handleInput )
+ * \brief	Advances the 3d environment in steps of fixed length.
+ *
+ * The passed time is collected, and for each full step of SIMULATION_STEP milliseconds
+ * the input is handled and the world is updated, so the results do not depend on the
+ * frame rate and fast ships can not pass through each other in long frames. At most
+ * MAX_SIMULATION_STEPS steps are done in one frame, the remaining time is dropped so
+ * that a slow computer does not fall further behind. The rest of the time that is
+ * shorter than a step is kept for the next frame and used to interpolate the drawn
+ * positions.
+ * \param	deltaTime	passed time in milliseconds
+ * \param	handleInput	false, if the keys are used by the console
+ */
+void App::simulateCurrentSystem( DWORD deltaTime, bool handleInput ) {
+  simulationAccumulator += deltaTime;
+  for( unsigned int steps = 0; simulationAccumulator >= SIMULATION_STEP; steps++ ) {
+    if( steps == MAX_SIMULATION_STEPS ) {
+      simulationAccumulator %= SIMULATION_STEP;
+      return;
+    }
+    ProfileZone zone( "simulation step" );
+    if( handleInput )
+      performCurrentSystemInput( SIMULATION_STEP );
+    updateCurrentSystem( SIMULATION_STEP );
+    simulationAccumulator -= SIMULATION_STEP;
+    if( currentScreen != currentSystem || gameOver ) {
+      simulationAccumulator = 0;
+      return;
+    }
+  }
+}
+
 /**
  * \fn	void App::stationWasHit()
  *
@@ -1887,12 +1989,11 @@ case systemInfo:
  */
 
 void App::stationWasHit(){
-	vector <PoliceShip*> * pships = World::getWorld()->getPoliceShips();
-	for (unsigned int i = 0; i < pships->size(); i++)
+	const vector <PoliceShip*> &pships = World::getWorld()->getPoliceShips();
+	for (unsigned int i = 0; i < pships.size(); i++)
 	{
-		pships->at(i)->stationWasHit();
+		pships[i]->stationWasHit();
 	}
-	delete pships;
 }
 
 /**
@@ -1905,15 +2006,9 @@ void App::stationWasHit(){
  * \param	deltaTime	passed time in milliseconds
  */
 void App::updateCurrentSystem( DWORD deltaTime ) {
-  // update the game environment in 3d-system-view
-  // move camera and adjust frustum
-  player->update( deltaTime );
-  frustum->setFrustumInformation( getWindow()->getFrustum() );
-  frustum->update( player );
-
-  // delete all objects that hav hit each other
-  World::getWorld()->deleteCrashedShips();
-  World::getWorld()->deleteDestroyedShips();
+  // update the game environment in 3d-system-view: move the player, the ships
+  // and the planets and delete all objects that have hit each other
+  World::getWorld()->tick( deltaTime );
 
   // test if on the way to station
   SpaceStation *coriolis = World::getWorld()->getStation();
@@ -1924,96 +2019,50 @@ void App::updateCurrentSystem( DWORD deltaTime ) {
 
   // get all the objects from the world and check if an object was hit or if the player collided with
   // an object. the objects have to be deleted after performing the tests
-  vector<GraphicsObject*> *objects = World::getWorld()->getGraphicObjects();
-  for( unsigned int i=0; i < objects->size(); i++ ) {// check if we hit another space ship
-    Vector3 v = objects->at(i)->getPos() - player->getPos();
+  const vector<GraphicsObject*> &objects = World::getWorld()->getGraphicObjects();
+  for( unsigned int i=0; i < objects.size(); i++ ) {// check if we hit another space ship
+    Vector3 v = objects[i]->getPos() - player->getPos();
     float distance = v.length();
-    float shieldDist = objects->at(i)->getRadius() + player->getRadius();
+    float shieldDist = objects[i]->getRadius() + player->getRadius();
     if( distance <shieldDist) {
       printInfoLine( "You hit an object");
       gameOver = true;
     }
   }
-  delete objects;
-
-  vector<SpaceShip*> *ships = World::getWorld()->getSpaceShips();
-  for( unsigned i=0; i < ships->size(); i++ ) {
-    ships->at(i)->update( deltaTime );
-    if( ships->at(i)->isShooting() ) {
-      //printInfoLine( "You were hit by laser." );
-      player->receiveHitFront( deltaTime );
-      if( player->getFrontShieldPower() <= 0 )
-        //printInfoLine( "You are dead!" );
-        gameOver = true;
+
+  const vector<SpaceShip*> &ships = World::getWorld()->getSpaceShips();
+  for( unsigned i=0; i < ships.size(); i++ ) {
+    Vector3 v = ships[i]->getPos() - player->getPos();
+    if( v.length() < ships[i]->getRadius() + player->getRadius() ) {
+      printInfoLine( "You hit an object");
+      gameOver = true;
     }
   }
+  if( player->getFrontShieldPower() <= 0 )
+    //printInfoLine( "You are dead!" );
+    gameOver = true;
 
   if( laserActive ) { // check if laser is active and we hit an object
     player->setShoot( true );
     laserHeatBar->setCurrent( player->getLaserHeat() );
 
-	SpaceStation * myStation = World::getWorld()->getStation();
-
-    for( unsigned int i=0; i < ships->size()+1; i++ ) {
-      // check if we hit the the ships by laser
-      // ships not in frustum can't be hit by laser
-	  
-	  // support for laser hit test with station
-	  Vector3 myPos;
-	  float myRadius;
-	  if (i < ships->size())
-	  {
-		  myPos = ships->at(i)->getPos();
-		  myRadius = ships->at(i)->getRadius();
-	  }
-	  else
-	  {
-		  myPos = myStation->getPos();
-		  myRadius = myStation->getRadius();
-	  }
-
-      CullingLocation res = getFrustum()->isSphereInFrustum( myPos, myRadius );
-      if( res != outside ) {// ships can't be hit if they are outside the frustum
-        // (not optimized) calculation of the ray-sphere intersection between the players laser and space ships
-        Vector3 v = player->getView();      // the current view direction 
-        Vector3 c = myPos;//ships->at(i)->getPos(); // the center of sphere (object position)
-        Vector3 p = player->getPos();       // the ray initial point
-        Vector3 u = c-p;
-        float scalar = v.innerProduct( u );
-        scalar = scalar / v.length();
-        Vector3 projectionPosition = p + v  * scalar;
-        Vector3 distance = projectionPosition - c;
-        float distanceToRay = distance.length();
-		if( distanceToRay < myRadius ) { //ships->at(i)->getRadius() ) {
-          // check if projected point is behind or in front of eye point
-          // pfact is the factor used in the line equation p + pfact*v = projectionPosition.
-          // it is the same for all three elements of the vector, but it can't be calculated if the entry is zero.
-          // it can not happen that all three elements of v are zero because v is an orthonormal vector
-          float pfact;
-          if(v.x != 0)
-            pfact = (projectionPosition.x - p.x) / v.x;
-          else if(v.y != 0)
-            pfact = (projectionPosition.y - p.y) / v.y;
-          else if(v.z != 0)
-            pfact = (projectionPosition.z - p.z) / v.z;
-          if( pfact > 0 ) {
-            printInfoLine( "Object hit by laser." );
-			if (i < ships->size())
-				ships->at(i)->receiveHitFront( deltaTime );
-			else
-				this->stationWasHit();
-          }
-          // missing: calculate hit-distance (for accurate drawing of laser ---> if it hit's an object, 
-          // the laser should only be painted 'til it reaches this object
-          // also it's possible to hit more than one object
-        } 
-      }
+    // the laser stops at the first object that it hits, the beam is only drawn up to this object
+    laserHits.clear();
+    World::getWorld()->castRay( player->getPos(), player->getView(), LASER_RANGE, World::getWorld()->getPlayerRayId(), laserHits );
+    laserLength = LASER_RANGE;
+    if( !laserHits.empty() ) {
+      const RayHit &hit = laserHits[0];
+      laserLength = hit.distance;
+      printInfoLine( "Object hit by laser." );
+      if( hit.id == World::getWorld()->getStationRayId() )
+        this->stationWasHit();
+      else
+        ships[hit.id]->receiveHitFront( deltaTime );
     }
   } else {// no laser is used
     player->setShoot(false);
     laserHeatBar->setCurrent( player->getLaserHeat() );
   }
-  delete ships;
 }
 
 void App::updateSystemInfo( DWORD deltaTime ) {
@@ -2196,12 +2245,28 @@ void App::performSystemInfoInput( DWORD deltaTime ) {
  * \fn	void App::loadSystemTextures()
  * \brief	Loads textures for the current system.
  * 			
- * Called whenever a hyperjump has been performed. In developer mode,
- * detailed information on the loaded files is given, otherwise only a percent information.
+ * Called whenever a hyperjump has been performed. If all textures have been prefetched, they
+ * are only assigned to the slots and no loading screen is shown. Otherwise they are loaded
+ * from the files. In developer mode, detailed information on the loaded files is given,
+ * otherwise only a percent information.
  */
 
 void App::loadSystemTextures() {
    Textures::getTextures()->changeColors( m_switchColors );
+
+  // use the prefetched textures, if possible
+  vector<PlanetInfoGraphical> *systemPlanets = devmode ? World::getWorld()->getSystemPlanets( currentSystemInfoNumber ) : World::getWorld()->getSystemPlanets();
+  TextureName systemStar = devmode ? World::getWorld()->getSystemStarTexture( currentSystemInfoNumber ) : World::getWorld()->getSystemStarTexture();
+  bool prefetched = FileAccess::isTextureCached( systemStar );
+  for( unsigned int i=0; i < systemPlanets->size() && prefetched; i++ )
+    prefetched = FileAccess::isTextureCached( systemPlanets->at(i).texture );
+  if( prefetched ) {
+    for( unsigned int i=0; i < systemPlanets->size(); i++ )
+      FileAccess::loadTexture( FileAccess::getPlanetSlot(i), systemPlanets->at(i).texture );
+    FileAccess::loadTexture( star, systemStar );
+    return;
+  }
+
   glClear( GL_COLOR_BUFFER_BIT );
   // switch to fast mode in order to draw the display elements
   fastMode();
@@ -2283,25 +2348,57 @@ void App::loadSystemTextures() {
   glPopMatrix();
 }
 
+/**
+ * \fn	void App::prefetchLocalSystemTextures()
+ * \brief	Requests the textures of all systems in jump range to be loaded in the background.
+ * 			
+ * The textures are created while the player is in the current system, so that the textures
+ * can be used directly after a hyperjump.
+ */
+void App::prefetchLocalSystemTextures() {
+  for( unsigned int i=0; i < 256; i++ ) {
+    if( !World::getWorld()->isSystemLocal( i ) )
+      continue;
+    vector<PlanetInfoGraphical> *planets = World::getWorld()->getSystemPlanets( i );
+    for( unsigned int j=0; j < planets->size(); j++ )
+      FileAccess::prefetchTexture( planets->at(j).texture );
+    FileAccess::prefetchTexture( World::getWorld()->getSystemStarTexture( i ) );
+  }
+}
+
 /**
  * \fn	void App::loadAllNeededTextures()
  * \brief	Loads all needed textures into the textureslots, exclusive planets.
  * 			
  * Planets are loaded in loadSystemTextures. If special color mode is active, the colors are swapped.
+ * The files are decoded in parallel.
  */
 void App::loadAllNeededTextures() {
+  AssetLoader assets;
+  addNeededTextures( assets );
+  assets.load();
+}
+
+/**
+ * \fn	void App::addNeededTextures( AssetLoader &assets )
+ * \brief	Adds all needed textures, exclusive planets, to a loader.
+ *
+ * The color mode is set before, as it is used when the textures are created.
+ * \param	assets	the loader
+ */
+void App::addNeededTextures( AssetLoader &assets ) {
   Textures::getTextures()->reserve( 32 );
   Textures::getTextures()->changeColors( m_switchColors );
-  FileAccess::loadTexture( corona, sun_corona );
-  FileAccess::loadTexture( bar, bar_green_red );
-  FileAccess::loadTexture( radar, radar_tex );
-  FileAccess::loadTexture( sight, decal_sight );
-  FileAccess::loadTexture( font1, font_2 );
-  FileAccess::loadTexture( font2, font_3 );
-  FileAccess::loadTexture( laser, laser1 );
-  FileAccess::loadTexture( background, universe_1 );
-  FileAccess::loadTexture( missile_hud_tex, missile_hud );
-  FileAccess::loadTexture( rearview, missile_hud );
+  assets.addTexture( corona, sun_corona );
+  assets.addTexture( bar, bar_green_red );
+  assets.addTexture( radar, radar_tex );
+  assets.addTexture( sight, decal_sight );
+  assets.addTexture( font1, font_2 );
+  assets.addTexture( font2, font_3 );
+  assets.addTexture( laser, laser1 );
+  assets.addTexture( background, universe_1 );
+  assets.addTexture( missile_hud_tex, missile_hud );
+  assets.addTexture( rearview, missile_hud );
 }
 
 /**
@@ -2315,6 +2412,7 @@ void App::setScreen( Screens screen ) {
   if( screen == currentSystem && inStation ) {
     player->setPos( World::getWorld()->getStation()->getOutPosition() );
     player->setView( World::getWorld()->getStation()->getOutVector() ); // do stuff that we start outside the coriolis station
+    player->keepState(); // the launch is a jump, it is not interpolated
     player->setSpeed( player->getMaxSpeed()  * 0.5 );
     speedBar->setCurrent( player->getSpeed() );
     inStation = false;
@@ -2373,8 +2471,11 @@ void App::printInfoLine( const char*inputstring, ... ) {
 void App::printInfoBox( bool clear ) {
   static const int gap = 10;
   static const int size = tf2->getSize();
+  ProfileZone zone( "text" );
+  tf2->begin();
   for( unsigned int i=0; i<infoBoxLines.size(); i++)
     tf2->print(gap, getWindow()->getHeight() - gap - ++infoOutputLine*size, &infoBoxLines.at(i));
+  tf2->flush();
   if( clear )
     infoBoxLines.clear();
   infoOutputLine = 0;
@@ -2387,11 +2488,13 @@ void App::printInfoBox( bool clear ) {
 
 void App::showFrameRate() {
   char opt = Console::getSingleCharacterOption( string(ti->getText()) );
-  if( opt == '1' )
+  if( opt == '1' || opt == '2' ) {
     m_showFrameRate = true;
-  else if( opt == '0' )
+    m_showZones = opt == '2';
+  } else if( opt == '0' ) {
     m_showFrameRate = false;
-  else
+    m_showZones = false;
+  } else
     ; // error
 }
 
@@ -2404,14 +2507,46 @@ void App::showFrameRate() {
 
 void App::showFrameTime() {
   char opt = Console::getSingleCharacterOption(ti->getText() );
-  if( opt == '1' )
+  if( opt == '1' || opt == '2' ) {
     m_showFrameTime = true;
-  else if( opt == '0' )
+    m_showZones = opt == '2';
+  } else if( opt == '0' ) {
     m_showFrameTime = false;
-  else
+    m_showZones = false;
+  } else
     ; // error
 }
 
+/**
+ * \fn	void App::exportTrace()
+ * \brief	Saves the frames stored by the profiler as a trace for the chrome trace viewer.
+ *
+ * Called when the command has been typed into the console. The option is the file name.
+ */
+
+void App::exportTrace() {
+  string option = Console::getOption( ti->getText() );
+  if( option == "" )
+    option = "trace.json";
+  if( !Profiler::getProfiler()->exportTrace( option ) )
+    printInfoLine( "Could not write %s", option.c_str() );
+}
+
+/**
+ * \fn	void App::record()
+ * \brief	Captures the following frames into numbered images.
+ *
+ * Called when the command has been typed into the console. The option is the number of frames.
+ */
+
+void App::record() {
+  int frames = atoi( Console::getOption( ti->getText() ).c_str() );
+  if( frames > 0 )
+    getFrameCapture()->record( frames );
+  else
+    printInfoLine( "Usage: record n" );
+}
+
 /**
  * \fn	void App::showSpeed()
  * \brief	Sets the variable to show the speed.
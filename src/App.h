@@ -7,6 +7,8 @@
 
 // global includes
 #include "OpenGLApplication.h"// base class
+#include "SweepAndPrune.h"
+#include "Profiler.h"
 #include <vector>
 #include <string>
 
@@ -22,6 +24,8 @@ class MouseHandler;
 class Frustum;
 class HudLoadBar;
 class Button;
+class InstanceRenderer;
+class AssetLoader;
 
 /**
  * \class	App
@@ -47,7 +51,7 @@ public:
   void draw( void ); // draw the scene
 private:
   // initialization
-  void initializeObjects( void );// loads and initializes all used game models
+  void initializeObjects( AssetLoader &assets );// adds all used game models to a loader
   void initMarketplace( void ); // initializes the marketplace
   void initializeGFX( void ); // initializes graphics
   // some private draw functions
@@ -64,6 +68,7 @@ private:
   // some private update functions
   void stationWasHit();
   void updateCurrentSystem( DWORD deltaTime );
+  void simulateCurrentSystem( DWORD deltaTime, bool handleInput );
   void updateLocalSystems( DWORD deltaTime );
   void updateSystemInfo( DWORD deltaTime );
   // some private input handling functions
@@ -71,9 +76,6 @@ private:
   void performCurrentSystemInput( DWORD deltaTime );// handles input for current system screen
   void performLocalSystemsInput( DWORD deltaTime ); // handles input for local systems screen
   void performSystemInfoInput( DWORD deltaTime ); // handles input for system info screen
-public:
-  GLUquadricObj *getQuadricObject() { return quadObj; }
-private:
   bool gameOver;
   bool firstDraw;
   TextureLoader * loader;
@@ -92,7 +94,9 @@ private:
 public:
   // general initialization
   void loadAllNeededTextures();
+  void addNeededTextures( AssetLoader &assets );
   void loadSystemTextures();
+  void prefetchLocalSystemTextures();
 
   // objects used for games
   MouseHandler *mouse;// gives a mouse object used for mouse-handling
@@ -104,14 +108,12 @@ public:
   TextInput *ti; // input class, used for giving commands
   Console *con;// console
   Frustum *frustum;// frustum, used for culling of hidden objects
+  InstanceRenderer *shipRenderer;// draws the visible ships grouped by their model
 
 public:
   // some functions to get the objects
   Frustum * getFrustum( void );
 private:
-  // the quadric object that is used for the skysphere
-  GLUquadricObj *quadObj;
-
   // internal status
   bool m_inputmode;
   GLfloat lightspeed;
@@ -120,6 +122,9 @@ private:
 
   // game status
   bool laserActive;
+  float laserLength;  // distance to the first object hit by the laser of the player
+  std::vector<RayHit> laserHits;
+  DWORD simulationAccumulator;        // passed time that has not been simulated, less than a step after each update
 
   // information output
 public:
@@ -129,6 +134,8 @@ private:
   std::vector<std::string> infoBoxLines;
   bool m_showFrameRate;
   bool m_showFrameTime;
+  bool m_showZones;                   // shows the time of each profiler zone
+  std::vector<ZoneTime> zoneTimes;
   bool m_showSpeed;
   bool m_showResolution;
   unsigned int infoOutputLine;
@@ -145,6 +152,8 @@ private:
   // functions to change status with console
   void showFrameRate();
   void showFrameTime();
+  void exportTrace();
+  void record();
   void showSpeed();
   void showResolution();
   void showHelp();
@@ -152,7 +161,7 @@ private:
   void switchColors();
 
   // function pointer array for use with console commands
-  void (App::*fptr[10])( void );
+  void (App::*fptr[11])( void );
 
 private:
   // help functions
@@ -0,0 +1,203 @@
+/**
+ * Copyright Jan-Philipp Kappmeier, Melanie Schmidt
+ * \file	AssetLoader.cpp
+ * \brief	Implementation of the parallel startup loader.
+ */
+#include "AssetLoader.h"
+#include "FileAccess.h"
+#include "Textures.h"
+#include "TextureLoader.h"
+#include "Objects.h"
+#include "Mesh.h"
+
+using namespace std;
+
+AssetLoader::AssetLoader( void ) {
+  next = 0;
+  threadCount = 0;
+  totalTime = 0;
+  QueryPerformanceFrequency( &frequency );
+}
+
+//! Frees the decoded data that has not been uploaded.
+AssetLoader::~AssetLoader( void ) {
+  for( unsigned int i = 0; i < assets.size(); i++ ) {
+    delete assets[i].image;
+    delete assets[i].mesh;
+  }
+}
+
+//! Adds a texture that is loaded into a slot.
+/**
+ * If the same file is added for several slots, it is decoded only once. Files that
+ * are already in the texture cache are not decoded again.
+ * \param slot the slot
+ * \param texture the texture
+ */
+void AssetLoader::addTexture( TextureSlot slot, TextureName texture ) {
+  string filename = FileAccess::getTextureFile( texture );
+  for( unsigned int i = 0; i < assets.size(); i++ )
+    if( !assets[i].isObject && assets[i].filename == filename ) {
+      assets[i].slots.push_back( slot );
+      return;
+    }
+  Asset a;
+  a.filename = filename;
+  a.isObject = false;
+  a.slots.push_back( slot );
+  a.factor = 1;
+  a.cached = Textures::getTextures()->isCached( filename );
+  a.image = 0;
+  a.mesh = 0;
+  a.decodeTime = 0;
+  a.uploadTime = 0;
+  assets.push_back( a );
+}
+
+//! Adds a 3d object.
+/**
+ * \param object the object
+ */
+void AssetLoader::addObject( ObjectName object ) {
+  Asset a;
+  a.filename = FileAccess::getObjectFile( object );
+  a.isObject = true;
+  a.slots.push_back( object );
+  a.factor = FileAccess::getObjectFactor( object );
+  a.cached = false;
+  a.image = 0;
+  a.mesh = 0;
+  a.decodeTime = 0;
+  a.uploadTime = 0;
+  assets.push_back( a );
+}
+
+//! Decodes all assets in parallel and uploads them.
+/**
+ * Starts one worker for each processor core, but not more than assets, and waits
+ * until all of them are finished. Then the assets are uploaded in the order in which
+ * they were added. Files that could not be decoded are skipped.
+ */
+void AssetLoader::load( void ) {
+  LARGE_INTEGER start;
+  QueryPerformanceCounter( &start );
+
+  SYSTEM_INFO info;
+  GetSystemInfo( &info );
+  threadCount = min( (unsigned int)info.dwNumberOfProcessors, (unsigned int)assets.size() );
+  threadCount = min( threadCount, (unsigned int)MAXIMUM_WAIT_OBJECTS );
+  next = 0;
+  vector<HANDLE> threads;
+  for( unsigned int i = 0; i < threadCount; i++ ) {
+    HANDLE thread = CreateThread( NULL, 0, run, this, 0, NULL );
+    if( thread != NULL )
+      threads.push_back( thread );
+  }
+  if( !threads.empty() )
+    WaitForMultipleObjects( (DWORD)threads.size(), &threads[0], TRUE, INFINITE );
+  for( unsigned int i = 0; i < threads.size(); i++ )
+    CloseHandle( threads[i] );
+  work(); // decodes the remaining assets if no thread could be started
+
+  for( unsigned int i = 0; i < assets.size(); i++ ) {
+    Asset &a = assets[i];
+    LARGE_INTEGER uploadStart;
+    QueryPerformanceCounter( &uploadStart );
+    if( a.isObject && a.mesh != 0 ) {
+      Objects::getObjects()->loadObject( a.slots[0], a.filename, a.mesh );
+      a.mesh = 0; // owned by the objects now
+    } else if( !a.isObject && a.image != 0 ) {
+      for( unsigned int j = 0; j < a.slots.size(); j++ )
+        Textures::getTextures()->loadTexture( a.slots[j], a.filename, a.image );
+      delete a.image;
+      a.image = 0;
+    } else if( !a.isObject && a.cached ) {
+      for( unsigned int j = 0; j < a.slots.size(); j++ )
+        Textures::getTextures()->loadTexture( a.slots[j], a.filename );
+    }
+    a.uploadTime = getMilliseconds( uploadStart );
+  }
+  totalTime = getMilliseconds( start );
+}
+
+/**
+ * \brief The entry point of the worker threads.
+ * \param parameter the loader that started the thread
+ */
+DWORD WINAPI AssetLoader::run( LPVOID parameter ) {
+  static_cast<AssetLoader*>( parameter )->work();
+  return 0;
+}
+
+//! Decodes assets until all are taken.
+/**
+ * The index of the next asset is increased atomically, so each asset is decoded
+ * by exactly one thread. Only the decoding functions are called, which do not need
+ * an OpenGL context.
+ */
+void AssetLoader::work( void ) {
+  while( true ) {
+    LONG index = InterlockedIncrement( &next ) - 1;
+    if( index >= (LONG)assets.size() )
+      return;
+    Asset &a = assets[index];
+    LARGE_INTEGER start;
+    QueryPerformanceCounter( &start );
+    if( a.isObject )
+      a.mesh = Objects::decodeObject( a.filename, a.factor );
+    else if( !a.cached )
+      a.image = Textures::decodeTexture( a.filename );
+    a.decodeTime = getMilliseconds( start );
+  }
+}
+
+/**
+ * \brief Returns the milliseconds that have passed since a given performance counter value.
+ */
+float AssetLoader::getMilliseconds( LARGE_INTEGER start ) {
+  LARGE_INTEGER now;
+  QueryPerformanceCounter( &now );
+  return (float)( (double)(now.QuadPart - start.QuadPart) * 1000.0 / (double)frequency.QuadPart );
+}
+
+/**
+ * \brief Returns the number of added files. A texture used in several slots is counted once.
+ */
+unsigned int AssetLoader::getAssetCount( void ) {
+  return (unsigned int)assets.size();
+}
+
+/**
+ * \brief Returns the file of an asset.
+ */
+const std::string & AssetLoader::getFilename( unsigned int index ) {
+  return assets[index].filename;
+}
+
+/**
+ * \brief Returns the time in milliseconds a worker needed to decode an asset.
+ */
+float AssetLoader::getDecodeTime( unsigned int index ) {
+  return assets[index].decodeTime;
+}
+
+/**
+ * \brief Returns the time in milliseconds needed to upload an asset to the graphics card.
+ */
+float AssetLoader::getUploadTime( unsigned int index ) {
+  return assets[index].uploadTime;
+}
+
+/**
+ * \brief Returns the time in milliseconds that load() needed.
+ */
+float AssetLoader::getTotalTime( void ) {
+  return totalTime;
+}
+
+/**
+ * \brief Returns the number of worker threads used by the last load().
+ */
+unsigned int AssetLoader::getThreadCount( void ) {
+  return threadCount;
+}
@@ -0,0 +1,65 @@
+/**
+ * Copyright Jan-Philipp Kappmeier, Melanie Schmidt
+ * \file	AssetLoader.h
+ * \brief	Declares a loader that decodes the models and textures needed at startup in parallel.
+ */
+#pragma once
+
+#include "GlobalGL.h"
+#include "Structures.h"
+#include <string>
+#include <vector>
+
+class TextureLoader;
+class Mesh;
+
+//! Loads a set of models and textures using all processor cores.
+/**
+ * The assets are collected with addTexture() and addObject() and loaded at once by
+ * load(). A pool of worker threads, one for each core, decodes the files: the images
+ * are read and the meshes are taken from their cache or converted. Each worker takes
+ * the next asset that is not decoded yet, so no locks are needed. After all workers
+ * are finished, the textures and meshes are uploaded to the graphics card one after
+ * another in the calling thread, which has to own the OpenGL context.
+ *
+ * The time needed to decode and to upload each asset is measured and can be queried
+ * after loading.
+ */
+class AssetLoader {
+public:
+  AssetLoader( void );
+  ~AssetLoader( void );
+
+  void addTexture( TextureSlot slot, TextureName texture );
+  void addObject( ObjectName object );
+  void load( void );
+
+  unsigned int getAssetCount( void );
+  const std::string & getFilename( unsigned int index );
+  float getDecodeTime( unsigned int index );
+  float getUploadTime( unsigned int index );
+  float getTotalTime( void );
+  unsigned int getThreadCount( void );
+private:
+  static DWORD WINAPI run( LPVOID parameter );
+  void work( void );
+  float getMilliseconds( LARGE_INTEGER start );
+
+  //! A file that is loaded, either an image or a model.
+  struct Asset {
+    std::string filename;
+    bool isObject;
+    std::vector<unsigned int> slots;  // the texture slots or the object number
+    float factor;                     // the scale factor of a model
+    bool cached;                      // true, if the texture is already in the texture cache
+    TextureLoader *image;
+    Mesh *mesh;
+    float decodeTime;
+    float uploadTime;
+  };
+  std::vector<Asset> assets;
+  volatile LONG next;                 // the next asset that is decoded by a worker
+  unsigned int threadCount;
+  float totalTime;
+  LARGE_INTEGER frequency;
+};
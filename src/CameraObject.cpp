@@ -63,10 +63,12 @@ bool CameraObject::isRearView() {
  * the correct position. 
  */
 void CameraObject::look() {
+#ifndef MELITE_HEADLESS
   if( m_rearView )
     gluLookAt( getPos().x, getPos().y, getPos().z, getPos().x - getView().x, getPos().y - getView().y, getPos().z - getView().z, getUp().x, getUp().y, getUp().z );
   else
     gluLookAt( getPos().x, getPos().y, getPos().z, getPos().x + getView().x, getPos().y + getView().y, getPos().z + getView().z, getUp().x, getUp().y, getUp().z );
+#endif
 }
 
 /**
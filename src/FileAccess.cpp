@@ -5,8 +5,10 @@
  */
 #include "GlobalParameters.h"
 #include "FileAccess.h"
+#ifndef MELITE_HEADLESS
 #include "Textures.h"
 #include "Objects.h"
+#endif
 
 using namespace std;
 
@@ -70,6 +72,8 @@ TextureAccess FileAccess::getTextureInfo( TextureName texture ) {
   return textureInfos[texture];
 }
 
+#ifndef MELITE_HEADLESS
+// the headless build has no textures, the loading functions are not available
 /**
  * Loads a texture which is provided as a TextureName into a TextureSlot.
  * 
@@ -83,6 +87,25 @@ void FileAccess::loadTexture( TextureSlot slot, TextureName texture ) {
    Textures::getTextures()->loadTexture( slot, getTextureFile( texture ) );
 }
 
+/**
+ * Requests a texture to be loaded in the background, so that it can be loaded
+ * into a slot later without delay.
+ * \param texture the texture
+ */
+void FileAccess::prefetchTexture( TextureName texture ) {
+  Textures::getTextures()->prefetchTexture( getTextureFile( texture ) );
+}
+
+/**
+ * Checks whether a texture has already been loaded and can be put into a slot
+ * without delay.
+ * \param texture the texture
+ */
+bool FileAccess::isTextureCached( TextureName texture ) {
+  return Textures::getTextures()->isCached( getTextureFile( texture ) );
+}
+#endif
+
 /**
  * Returns the filename for an object given as ObjectName. 
  * \param object the given object 
@@ -116,6 +139,7 @@ float FileAccess::getObjectFactor( ObjectName object ) {
   return getObjectInfo( object ).factor;
 }
 
+#ifndef MELITE_HEADLESS
 /**
  * \brief Loads a 3d object from a file.
  * 
@@ -126,6 +150,7 @@ float FileAccess::getObjectFactor( ObjectName object ) {
 void FileAccess::loadObject( ObjectName object ) {
   Objects::getObjects()->loadObject( object, getObjectFile( object ), getObjectFactor( object ) );
 }
+#endif
 
 const TextureSlot FileAccess::planetSlots[] = {
   planet1,
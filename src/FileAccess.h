@@ -62,6 +62,8 @@ public:
   static std::string getTextureFile( TextureName texture );
   static TextureAccess getTextureInfo( TextureName texture );
   static void loadTexture( TextureSlot slot, TextureName texture );
+  static void prefetchTexture( TextureName texture );
+  static bool isTextureCached( TextureName texture );
 private:
   static const int planetSlotCount = 10;
   static const TextureSlot planetSlots[];
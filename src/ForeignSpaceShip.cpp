@@ -5,16 +5,100 @@
  */
 #include "ForeignSpaceShip.h"
 
-ForeignSpaceShip::ForeignSpaceShip(float r, GLuint displayList):SpaceShip(r,displayList)
+ForeignSpaceShip::ForeignSpaceShip(float r, Mesh *mesh):SpaceShip(r,mesh)
 {
+	m_playerDistance = 0;
+	m_player.speed = 0;
+	m_steering.changeSpeed = m_steering.changeShoot = m_steering.changeView = false;
 }
 
 ForeignSpaceShip::~ForeignSpaceShip(void)
 {
 }
 
-void ForeignSpaceShip::update( float t)
+//! Steers the ship with the behavior of the derived class.
+/**
+ * The state of the player has to be set before, see setPlayerState().
+ * \param t the delta time in milliseconds
+ */
+void ForeignSpaceShip::steer( float t)
+{
+	decide(t);
+	applySteering();
+}
+
+//! Computes the steering of the derived class without changing the ship.
+/**
+ * Only the steering and the internal state of the derived class are written, so the
+ * ships can decide in parallel. The state of the player has to be set before.
+ * \param t the delta time in milliseconds
+ */
+void ForeignSpaceShip::decide( float t)
 {
+	m_steering.changeSpeed = m_steering.changeShoot = m_steering.changeView = false;
 	adjust(t);
-	SpaceShip::update(t);
+}
+
+/**
+ * \brief Sets speed, laser and view computed by the last decide(), if they were changed.
+ */
+void ForeignSpaceShip::applySteering(void)
+{
+	if (m_steering.changeSpeed)
+		setSpeed(m_steering.speed);
+	if (m_steering.changeShoot)
+		setShoot(m_steering.shoot);
+	if (m_steering.changeView)
+		setView(m_steering.view);
+	m_steering.changeSpeed = m_steering.changeShoot = m_steering.changeView = false;
+}
+
+//! Sets the state of the player and the vector from the ship to the player.
+/**
+ * The world computes the offsets of all ships in one batch, see ShipStates.
+ * \param player the state of the player, the same for all ships
+ * \param offset the vector from the ship to the player
+ * \param distance the length of the offset
+ */
+void ForeignSpaceShip::setPlayerState( const PlayerSnapshot &player, const Vector3 &offset, float distance )
+{
+	m_player = player;
+	m_playerOffset = offset;
+	m_playerDistance = distance;
+}
+
+/**
+ * \brief Sets the speed the ship will have after the steering is applied.
+ */
+void ForeignSpaceShip::steerSpeed( float speed )
+{
+	m_steering.changeSpeed = true;
+	m_steering.speed = speed;
+}
+
+/**
+ * \brief Sets whether the ship will shoot after the steering is applied.
+ */
+void ForeignSpaceShip::steerShoot( bool shoot )
+{
+	m_steering.changeShoot = true;
+	m_steering.shoot = shoot;
+}
+
+/**
+ * \brief Sets the view the ship will have after the steering is applied.
+ */
+void ForeignSpaceShip::steerView( const Vector3 &view )
+{
+	m_steering.changeView = true;
+	m_steering.view = view;
+}
+
+/**
+ * \brief Tests whether the ship is behind the plane through the player, orthogonal to the player's view.
+ */
+bool ForeignSpaceShip::behindPlayer()
+{
+	Plane plane = Plane(m_player.view, m_player.pos);
+	return ( plane.distance( this->getPos()) < 0);
 }
\ No newline at end of file
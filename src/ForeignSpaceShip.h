@@ -4,18 +4,54 @@
  * \brief Declaration of a general space ship.
  */
 #pragma once
-#include "spaceship.h"
+#include "SpaceShip.h"
 #include "Plane.h"
 
-class ForeignSpaceShip abstract :
+//! The state of the player that the foreign ships react on, copied once before they are steered.
+struct PlayerSnapshot {
+  Vector3 pos;
+  Vector3 view;
+  float speed;
+};
+
+//! A space ship that is steered by the computer.
+/**
+ * Steering is divided into two phases. decide() lets the derived class compute the
+ * new speed, view and laser state from the copied player state and the own state,
+ * but only stores them. As no other object is changed, the ships can decide in
+ * parallel. applySteering() sets the stored values afterwards.
+ */
+class ForeignSpaceShip :
   public SpaceShip
 {
 public:
-  ForeignSpaceShip(float r, GLuint displayList);
+  ForeignSpaceShip(float r, Mesh *mesh);
 public:
   ~ForeignSpaceShip(void);
 private:
   virtual void adjust( float t )=0;  
 public:
-  void update(float t);
+  void steer(float t);
+  void decide(float t);
+  void applySteering(void);
+  void setPlayerState( const PlayerSnapshot &player, const Vector3 &offset, float distance );
+protected:
+  void steerSpeed( float speed );
+  void steerShoot( bool shoot );
+  void steerView( const Vector3 &view );
+  bool behindPlayer();
+  PlayerSnapshot m_player;	// the player at the beginning of the step
+  Vector3 m_playerOffset;	// vector from the ship to the player
+  float m_playerDistance;	// length of m_playerOffset
+private:
+  //! The changes computed by adjust(), the last value of each kind is kept.
+  struct Steering {
+    bool changeSpeed;
+    float speed;
+    bool changeShoot;
+    bool shoot;
+    bool changeView;
+    Vector3 view;
+  };
+  Steering m_steering;
 };
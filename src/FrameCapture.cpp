@@ -0,0 +1,304 @@
+/**
+ * Copyright Jan-Philipp Kappmeier, Melanie Schmidt
+ * \file	FrameCapture.cpp
+ * \brief	Implementation of the frame capture.
+ */
+#include "FrameCapture.h"
+#include "TextureLoaderTGA.h"
+#include <cstddef>
+#include <cstring>
+
+using namespace std;
+
+// pixel buffer objects are part of OpenGL 2.1, the windows headers only support version 1.1
+#ifndef GL_PIXEL_PACK_BUFFER
+#define GL_PIXEL_PACK_BUFFER 0x88EB
+#define GL_STREAM_READ 0x88E1
+#define GL_READ_ONLY 0x88B8
+#endif
+
+typedef void (APIENTRY * BindBufferFunction)( GLenum target, GLuint buffer );
+typedef void (APIENTRY * GenBuffersFunction)( GLsizei n, GLuint *buffers );
+typedef void (APIENTRY * DeleteBuffersFunction)( GLsizei n, const GLuint *buffers );
+typedef void (APIENTRY * BufferDataFunction)( GLenum target, ptrdiff_t size, const GLvoid *data, GLenum usage );
+typedef GLvoid* (APIENTRY * MapBufferFunction)( GLenum target, GLenum access );
+typedef GLboolean (APIENTRY * UnmapBufferFunction)( GLenum target );
+
+static BindBufferFunction bindBuffer = 0;
+static GenBuffersFunction genBuffers = 0;
+static DeleteBuffersFunction deleteBuffers = 0;
+static BufferDataFunction bufferData = 0;
+static MapBufferFunction mapBuffer = 0;
+static UnmapBufferFunction unmapBuffer = 0;
+static bool bufferFunctionsLoaded = false;
+
+//! Gets the addresses of the pixel buffer functions from the driver.
+/**
+ * The addresses are only available if a rendering context exists, so they are
+ * loaded when the first frame is captured.
+ * \return true, if pixel buffer objects are supported
+ */
+static bool loadBufferFunctions( void ) {
+  if( !bufferFunctionsLoaded ) {
+    bindBuffer = (BindBufferFunction)wglGetProcAddress( "glBindBuffer" );
+    genBuffers = (GenBuffersFunction)wglGetProcAddress( "glGenBuffers" );
+    deleteBuffers = (DeleteBuffersFunction)wglGetProcAddress( "glDeleteBuffers" );
+    bufferData = (BufferDataFunction)wglGetProcAddress( "glBufferData" );
+    mapBuffer = (MapBufferFunction)wglGetProcAddress( "glMapBuffer" );
+    unmapBuffer = (UnmapBufferFunction)wglGetProcAddress( "glUnmapBuffer" );
+    bufferFunctionsLoaded = true;
+  }
+  return bindBuffer && genBuffers && deleteBuffers && bufferData && mapBuffer && unmapBuffer;
+}
+
+/**
+ * \brief Sets up an idle capture. The encoder thread is started with the first frame.
+ */
+FrameCapture::FrameCapture( void ) {
+  InitializeCriticalSection( &lock );
+  wakeUp = CreateEvent( NULL, FALSE, FALSE, NULL );
+  taken = CreateEvent( NULL, FALSE, FALSE, NULL );
+  thread = NULL;
+  stopping = false;
+  for( unsigned int i = 0; i < 2; i++ ) {
+    buffers[i] = 0;
+    bufferSizes[i] = 0;
+    filled[i] = false;
+  }
+  current = 0;
+  framesLeft = 0;
+  recording = false;
+  screenshotNumber = 0;
+  recordNumber = 0;
+}
+
+//! Waits until the encoder has written all queued frames.
+/**
+ * Frames that are still in a pixel buffer are lost, release() has to be called before
+ * while the rendering context exists.
+ */
+FrameCapture::~FrameCapture( void ) {
+  if( thread != NULL ) {
+    EnterCriticalSection( &lock );
+    stopping = true;
+    LeaveCriticalSection( &lock );
+    SetEvent( wakeUp );
+    WaitForSingleObject( thread, INFINITE );
+    CloseHandle( thread );
+  }
+  CloseHandle( wakeUp );
+  CloseHandle( taken );
+  DeleteCriticalSection( &lock );
+}
+
+/**
+ * \brief Captures the next frame. Ignored while frames are recorded.
+ */
+void FrameCapture::screenshot( void ) {
+  if( framesLeft > 0 )
+    return;
+  framesLeft = 1;
+  recording = false;
+}
+
+/**
+ * \brief Captures the following frames, numbered from zero. A running recording is restarted.
+ * \param frames the number of frames
+ */
+void FrameCapture::record( unsigned int frames ) {
+  framesLeft = frames;
+  recording = true;
+  recordNumber = 0;
+}
+
+/**
+ * \brief Returns true, if a frame is requested or a frame is in a pixel buffer.
+ */
+bool FrameCapture::isCapturing( void ) {
+  return framesLeft > 0 || filled[0] || filled[1];
+}
+
+//! Captures the current frame, if one is requested.
+/**
+ * Has to be called after the frame is drawn and before the buffers are swapped. The
+ * frame is copied from the back buffer into the current pixel buffer, then the frame
+ * copied in the last call is taken from the other buffer and handed to the encoder.
+ * \param width the width of the window
+ * \param height the height of the window
+ */
+void FrameCapture::capture( unsigned int width, unsigned int height ) {
+  if( !isCapturing() )
+    return;
+  glPushClientAttrib( GL_CLIENT_PIXEL_STORE_BIT );
+  glPixelStorei( GL_PACK_ALIGNMENT, 1 ); // the rows are written tightly packed
+  unsigned int size = width * height * 3;
+
+  if( !loadBufferFunctions() ) {
+    // read directly, waits until the frame is finished
+    string filename;
+    nextFile( filename );
+    BYTE *image = new BYTE[size];
+    glReadPixels( 0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, image );
+    submit( filename, image, width, height );
+    framesLeft--;
+    glPopClientAttrib();
+    return;
+  }
+
+  if( framesLeft > 0 ) {
+    if( buffers[current] == 0 )
+      genBuffers( 1, &buffers[current] );
+    bindBuffer( GL_PIXEL_PACK_BUFFER, buffers[current] );
+    if( bufferSizes[current] != size ) {
+      bufferData( GL_PIXEL_PACK_BUFFER, size, NULL, GL_STREAM_READ );
+      bufferSizes[current] = size;
+    }
+    glReadPixels( 0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, 0 ); // returns at once
+    nextFile( reading[current].filename );
+    reading[current].width = width;
+    reading[current].height = height;
+    filled[current] = true;
+    framesLeft--;
+  }
+
+  // the copy into the other buffer was started one frame ago and should be finished
+  unsigned int previous = 1 - current;
+  if( filled[previous] )
+    submitBuffer( previous );
+  bindBuffer( GL_PIXEL_PACK_BUFFER, 0 );
+  current = previous;
+  glPopClientAttrib();
+}
+
+/**
+ * \brief Submits the frames left in the pixel buffers and deletes the buffers. Has to be called while the rendering context is current.
+ */
+void FrameCapture::release( void ) {
+  if( loadBufferFunctions() ) {
+    for( unsigned int i = 0; i < 2; i++ ) {
+      unsigned int index = (current + i) % 2; // the older frame first
+      if( filled[index] )
+        submitBuffer( index );
+    }
+    bindBuffer( GL_PIXEL_PACK_BUFFER, 0 );
+    for( unsigned int i = 0; i < 2; i++ )
+      if( buffers[i] != 0 )
+        deleteBuffers( 1, &buffers[i] );
+  }
+  for( unsigned int i = 0; i < 2; i++ ) {
+    buffers[i] = 0;
+    bufferSizes[i] = 0;
+    filled[i] = false;
+  }
+  framesLeft = 0;
+}
+
+/**
+ * \brief Copies the frame from a pixel buffer and submits it. Waits if the frame is not copied into the buffer yet.
+ */
+void FrameCapture::submitBuffer( unsigned int index ) {
+  const Frame &frame = reading[index];
+  bindBuffer( GL_PIXEL_PACK_BUFFER, buffers[index] );
+  const BYTE *data = (const BYTE *)mapBuffer( GL_PIXEL_PACK_BUFFER, GL_READ_ONLY );
+  if( data != 0 ) {
+    BYTE *image = new BYTE[frame.width * frame.height * 3];
+    memcpy( image, data, frame.width * frame.height * 3 );
+    unmapBuffer( GL_PIXEL_PACK_BUFFER );
+    submit( frame.filename, image, frame.width, frame.height );
+  }
+  filled[index] = false;
+}
+
+/**
+ * \brief The entry point of the encoder thread.
+ * \param parameter the capture that started the thread
+ */
+DWORD WINAPI FrameCapture::run( LPVOID parameter ) {
+  static_cast<FrameCapture*>( parameter )->encode();
+  return 0;
+}
+
+//! Writes the queued frames until the capture is destroyed.
+/**
+ * The thread sleeps until a frame is queued. Only the writing functions of the
+ * texture loader are used, which do not need an OpenGL context.
+ */
+void FrameCapture::encode( void ) {
+  while( true ) {
+    WaitForSingleObject( wakeUp, INFINITE );
+    while( true ) {
+      EnterCriticalSection( &lock );
+      if( queue.empty() ) {
+        bool stop = stopping;
+        LeaveCriticalSection( &lock );
+        if( stop )
+          return;
+        break;
+      }
+      Frame frame = queue.front();
+      queue.pop_front();
+      LeaveCriticalSection( &lock );
+      SetEvent( taken );
+
+      write( frame );
+    }
+  }
+}
+
+//! Queues a frame for the encoder, which takes the ownership of the image.
+/**
+ * If maxQueuedFrames frames are waiting, the rendering thread waits until the encoder
+ * has taken one, so the memory used by the queue is bounded.
+ */
+void FrameCapture::submit( const string &filename, BYTE *image, unsigned int width, unsigned int height ) {
+  Frame frame;
+  frame.filename = filename;
+  frame.image = image;
+  frame.width = width;
+  frame.height = height;
+  if( thread == NULL )
+    thread = CreateThread( NULL, 0, run, this, 0, NULL );
+  if( thread == NULL ) {
+    write( frame ); // no encoder available, write in the rendering thread
+    return;
+  }
+  while( true ) {
+    EnterCriticalSection( &lock );
+    if( queue.size() < maxQueuedFrames ) {
+      queue.push_back( frame );
+      LeaveCriticalSection( &lock );
+      break;
+    }
+    LeaveCriticalSection( &lock );
+    WaitForSingleObject( taken, INFINITE );
+  }
+  SetEvent( wakeUp );
+}
+
+/**
+ * \brief Writes a frame into a Targa file and frees its image.
+ */
+void FrameCapture::write( const Frame &frame ) {
+  TextureLoader *loader = new TextureLoaderTGA();
+  loader->load( frame.image, frame.width, frame.height, 3 );
+  loader->write( frame.filename );
+  delete loader;
+}
+
+//! Returns the name of the file for the next captured frame.
+/**
+ * A recorded frame is named capture followed by its number. A screenshot gets the
+ * first number that is not used by an existing screenshot.
+ * \param filename is set to the name
+ */
+void FrameCapture::nextFile( string &filename ) {
+  char name[32];
+  if( recording ) {
+    sprintf_s( name, "capture%05u.tga", recordNumber++ );
+  } else {
+    do {
+      sprintf_s( name, "screenshot%04u.tga", screenshotNumber++ );
+    } while( GetFileAttributes( name ) != INVALID_FILE_ATTRIBUTES );
+  }
+  filename = name;
+}
@@ -0,0 +1,72 @@
+/**
+ * Copyright Jan-Philipp Kappmeier, Melanie Schmidt
+ * \file	FrameCapture.h
+ * \brief	Declares the FrameCapture class that stores rendered frames as images without stalling the rendering.
+ */
+#pragma once
+
+#include "GlobalGL.h"
+#include <string>
+#include <deque>
+
+//! Reads rendered frames back from the graphics card and writes them into Targa files.
+/**
+ * A capture is requested with screenshot() for one frame or with record() for a
+ * number of following frames. At the end of each frame, before the buffers are swapped,
+ * capture() starts to copy the frame into one of two pixel buffer objects. The copy is
+ * done by the graphics card while the next frame is rendered, so the image is mapped
+ * and handed to the encoder one frame later, from the other buffer. If pixel buffer
+ * objects are not supported, the frame is read directly, which waits for the graphics
+ * card.
+ *
+ * The images are converted and written by a background thread, thus the disk is not
+ * accessed in the rendering thread. The frames waiting for the encoder are kept in a
+ * queue protected by a critical section. The queue holds at most a few frames; if the
+ * encoder is slower than the rendering, a new frame waits until the encoder has taken
+ * the oldest one, so no frame of a recording is lost. Screenshots are numbered after the ones that
+ * already exist, the frames of a recording are numbered from zero, so two recordings
+ * of the same scene can be compared file by file.
+ */
+class FrameCapture {
+public:
+  FrameCapture( void );
+  ~FrameCapture( void );
+  void screenshot( void );
+  void record( unsigned int frames );
+  bool isCapturing( void );
+  void capture( unsigned int width, unsigned int height );
+  void release( void );
+private:
+  static DWORD WINAPI run( LPVOID parameter );
+  void encode( void );
+  void submit( const std::string &filename, BYTE *image, unsigned int width, unsigned int height );
+  void submitBuffer( unsigned int index );
+  void nextFile( std::string &filename );
+
+  //! A frame that is read back or waits to be encoded.
+  struct Frame {
+    std::string filename;
+    BYTE *image;
+    unsigned int width;
+    unsigned int height;
+  };
+  static void write( const Frame &frame );
+  static const unsigned int maxQueuedFrames = 4;
+  std::deque<Frame> queue;            // frames waiting for the encoder
+  CRITICAL_SECTION lock;              // protects the queue and stopping
+  HANDLE wakeUp;                      // signaled if a frame is queued or the encoder has to stop
+  HANDLE taken;                       // signaled if the encoder has taken a frame from the queue
+  HANDLE thread;
+  bool stopping;
+
+  GLuint buffers[2];                  // the pixel buffers, written alternately
+  unsigned int bufferSizes[2];
+  Frame reading[2];                   // the frame that is copied into a buffer, the image is unused
+  bool filled[2];                     // true, if a buffer contains a frame that has not been submitted
+  unsigned int current;               // the buffer written in the next frame
+
+  unsigned int framesLeft;            // frames that are captured in the following frames
+  bool recording;
+  unsigned int screenshotNumber;
+  unsigned int recordNumber;
+};
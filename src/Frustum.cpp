@@ -29,6 +29,7 @@ void Frustum::setFrustumInformation( FrustumInformation frustum ) {
  * \param camera The camera object to which the frustum belongs.
  */
 void Frustum::update( CameraObject *camera ) {
+  eye = camera->getPos();
 
   // calculate positions of far plane edges
   Vector3 farCenter = camera->getPos() + camera->getView()  * frustum.farDist;
@@ -161,3 +162,18 @@ float Frustum::getFrustumHeight( float dist ) {
   float val = 2 * tan( frustum.fov * ANGLE2DEG * 0.5 ) * dist;
   return val;
 }
+
+/**
+ * Calculates the part of the screen height that is covered by a sphere. The diameter of
+ * the sphere is divided by the height of the frustum in the distance of the sphere,
+ * independent of the direction of view. The far plane is not taken into account.
+ * \param p The center of the sphere
+ * \param radius The radius of the sphere
+ * \return The diameter on the screen relative to the screen height, 1 if the eye is inside the sphere
+ */
+float Frustum::getProjectedSize( const Vector3 &p, float radius ) {
+  float dist = (eye - p).length();
+  if( dist <= radius )
+    return 1;
+  return (2 * radius) / (2 * tan( frustum.fov * ANGLE2DEG * 0.5 ) * dist);
+}
@@ -31,6 +31,7 @@ public:
 
   float Frustum::getFrustumWidth( float dist );
   float Frustum::getFrustumHeight( float dist );
+  float getProjectedSize( const Vector3 &p, float radius );
   CullingLocation isPointInFrustum( const Vector3 &p );
   CullingLocation isSphereInFrustum( const Vector3 &p, float radius );
   bool isInUpperHalf( const Vector3 &p );
@@ -56,6 +57,7 @@ private:
   Vector3 nearTopRight;
   Vector3 nearBottomLeft;
   Vector3 nearBottomRight;
+  Vector3 eye;
 
   FrustumInformation frustum;
 };
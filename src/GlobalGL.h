@@ -6,9 +6,21 @@
 #ifndef GLOBAL_H_
 #define GLOBAL_H_
 
+#ifndef MELITE_HEADLESS
 // basic includes for the work with OpenGL
 #include <windows.h> // Windows header. Needs to be included before glut, otherwise we get errors due to wrong definitions
 #include <GL/glut.h>
+#else
+// the headless simulation core is built without windows and OpenGL. only the
+// types used in the interfaces of the game objects are defined.
+#include <algorithm>
+typedef float GLfloat;
+typedef unsigned int GLuint;
+typedef void GLvoid;
+typedef unsigned long DWORD;
+using std::max;
+using std::min;
+#endif
 #include <stdio.h> // input/output
 #define _USE_MATH_DEFINES // activate mathmatic constants (pi, ...)
 #include <math.h>// mathmatic functions
@@ -12,4 +12,21 @@
 #define WINDOW_HEIGHT 600 //800 // 600
 #define WINDOW_WIDTH_FULL 1920
 #define WINDOW_HEIGHT_FULL 1080
+
+// the number of prefetched textures that are created in one frame
+#define TEXTURE_UPLOADS_PER_FRAME 1
+
+// the length of a laser beam, ships further away can not be hit
+#define LASER_RANGE 4000
+
+// the length of a simulation step in milliseconds and the maximal number of steps that
+// are simulated in one frame. time that needs more steps is dropped
+#define SIMULATION_STEP 20
+#define MAX_SIMULATION_STEPS 5
+
+// the number of ships from which on the ships decide how they steer in parallel
+#define PARALLEL_STEERING_SHIPS 32
+
+// the maximal number of jumps of the trade route shown in the marketplace
+#define TRADE_ROUTE_HOPS 3
 #endif // GLOBAL_PARAMETERS_H_
\ No newline at end of file
@@ -7,7 +7,7 @@
 
 #include "GlobalGL.h"
 #include "GameObject.h"
-#include "Vectormath.h"
+#include "VectorMath.h"
 
 //! Represents a basic drawable object. 
 /**
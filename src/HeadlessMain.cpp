@@ -0,0 +1,106 @@
+/**
+ * Copyright Jan-Philipp Kappmeier, Melanie Schmidt
+ * \file	HeadlessMain.cpp
+ * \brief	Defines the main function of the headless simulation build.
+ */
+#ifdef MELITE_HEADLESS
+#include "World.h"
+#include "PlayerObject.h"
+#include "SpaceShip.h"
+#include "Profiler.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+/**
+ * \brief Prints the most profitable trade route from each system of the current galaxy.
+ * \param hops the maximal number of jumps
+ * \param cash the cash at the start in credits
+ * \param holdspace the free holdspace at the start
+ * \param perFuel ranks by profit per light year instead of profit
+ */
+static void printTradeRoutes( unsigned int hops, float cash, unsigned int holdspace, bool perFuel ) {
+  World *world = World::getWorld();
+  std::vector<TradeRoute> *routes = world->findTradeRoutesFromAll( cash, holdspace, hops, perFuel );
+  double total = 0;
+  for( unsigned int i=0; i < routes->size(); i++ ) {
+    const TradeRoute &route = routes->at( i );
+    printf( "%s: %.1f CR in %.1f LY", world->getSystemName( i ).c_str(), route.profit, route.distance );
+    for( unsigned int j=0; j < route.legs.size(); j++ )
+      printf( "%s %s", j == 0 ? "," : " -", world->getSystemName( route.legs[j].to ).c_str() );
+    printf( "\n" );
+    total += route.profit;
+  }
+  printf( "average profit: %.2f CR\n", routes->empty() ? 0.0 : total / routes->size() );
+  delete routes;
+}
+
+/**
+ * \fn	int main( int argc, char *argv[] )
+ *
+ * \brief	Simulates a number of encounters in the current system without window
+ * 			and OpenGL.
+ *
+ * Each encounter initializes the world and runs it with a fixed time step until the
+ * player is dead or the maximal number of steps is reached. The player does not act.
+ * As the world is seeded, the results are the same in each run, so they can be used
+ * for balancing and regression tests.
+ *
+ * Each step is a frame of the Profiler. If a trace file is given, the distribution of
+ * the step times is printed and the last steps are exported as a trace.
+ *
+ * If the first argument is routes or routesPerFuel, the best trade route from each
+ * system is printed instead, ranked by profit or profit per light year.
+ *
+ * \param argc number of arguments
+ * \param argv the number of encounters, the maximal number of steps per encounter and
+ * optionally a trace file. For the routes the maximal number of jumps, the cash and
+ * the holdspace.
+ *
+ * \return 0
+ */
+int main( int argc, char *argv[] ) {
+  if( argc > 1 && ( strcmp( argv[1], "routes" ) == 0 || strcmp( argv[1], "routesPerFuel" ) == 0 ) ) {
+    printTradeRoutes( argc > 2 ? atoi( argv[2] ) : 3, argc > 3 ? (float)atof( argv[3] ) : 100.0f,
+                      argc > 4 ? atoi( argv[4] ) : 20, strcmp( argv[1], "routesPerFuel" ) == 0 );
+    return 0;
+  }
+  unsigned int encounters = argc > 1 ? atoi( argv[1] ) : 100;
+  unsigned int maxSteps = argc > 2 ? atoi( argv[2] ) : 3000;
+  const DWORD timeStep = 20; // milliseconds
+
+  World *world = World::getWorld();
+  unsigned int deaths = 0;
+  unsigned long shipsLeft = 0;
+  unsigned long steps = 0;
+  for( unsigned int i=0; i < encounters; i++ ) {
+    world->initialize();
+    for( unsigned int j=0; j < maxSteps; j++ ) {
+      world->tick( timeStep );
+      Profiler::getProfiler()->newFrame();
+      steps++;
+      if( world->getPlayer()->getFrontShieldPower() <= 0 ) {
+        deaths++;
+        break;
+      }
+    }
+    shipsLeft += (unsigned long)world->getSpaceShips().size();
+    world->deinitialize();
+  }
+
+  printf( "encounters: %u\n", encounters );
+  printf( "simulated steps: %lu (%lu ms)\n", steps, steps * timeStep );
+  printf( "player deaths: %u\n", deaths );
+  printf( "ships left on average: %.2f\n", encounters > 0 ? (double)shipsLeft / encounters : 0.0 );
+  if( argc > 3 ) {
+    // the times differ in each run, so they are only printed on request
+    Profiler *profiler = Profiler::getProfiler();
+    printf( "step time of the last %u steps: p50 %.3f ms, p95 %.3f ms, p99 %.3f ms\n", profiler->getFrameCount(),
+            profiler->getFrameTimePercentile( 50 ), profiler->getFrameTimePercentile( 95 ), profiler->getFrameTimePercentile( 99 ) );
+    if( !profiler->exportTrace( argv[3] ) )
+      printf( "could not write %s\n", argv[3] );
+  }
+  return 0;
+}
+#endif
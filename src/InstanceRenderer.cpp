@@ -0,0 +1,71 @@
+/**
+ * Copyright Jan-Philipp Kappmeier, Melanie Schmidt
+ * \file	InstanceRenderer.cpp
+ * \brief	Implementation of the renderer that draws ships grouped by their mesh.
+ */
+#include "InstanceRenderer.h"
+#include "Mesh.h"
+#include "SpaceShip.h"
+
+using namespace std;
+
+InstanceRenderer::InstanceRenderer( void ) {
+}
+
+InstanceRenderer::~InstanceRenderer( void ) {
+}
+
+/**
+ * \brief Removes all instances. Has to be called at the beginning of each frame.
+ */
+void InstanceRenderer::clear( void ) {
+  for( unsigned int i = 0; i < groups.size(); i++ )
+    groups[i].transformations.clear();
+}
+
+//! Adds a ship that is drawn in the next call of draw().
+/**
+ * The transformation of the ship is computed immediately and stored in the
+ * group of the ship's mesh. Ships without mesh are ignored.
+ * \param ship the ship
+ */
+void InstanceRenderer::add( SpaceShip * ship ) {
+  Mesh *mesh = ship->getMesh();
+  if( mesh == 0 )
+    return;
+
+  // there are only a few different models, so a linear search is fast enough
+  unsigned int g = 0;
+  while( g < groups.size() && groups[g].mesh != mesh )
+    g++;
+  if( g == groups.size() ) {
+    Group group;
+    group.mesh = mesh;
+    groups.push_back( group );
+  }
+
+  vector<GLfloat> &transformations = groups[g].transformations;
+  transformations.resize( transformations.size() + 16 );
+  ship->getTransformation( &transformations[transformations.size() - 16] );
+}
+
+/**
+ * \brief Draws all added ships, one group after another.
+ */
+void InstanceRenderer::draw( void ) {
+  for( unsigned int i = 0; i < groups.size(); i++ ) {
+    if( groups[i].transformations.empty() )
+      continue;
+    groups[i].mesh->drawInstances( &groups[i].transformations[0], (unsigned int)groups[i].transformations.size() / 16 );
+  }
+}
+
+/**
+ * \brief Returns the number of ships that have been added since the last call of clear().
+ */
+unsigned int InstanceRenderer::getInstanceCount( void ) {
+  unsigned int count = 0;
+  for( unsigned int i = 0; i < groups.size(); i++ )
+    count += (unsigned int)groups[i].transformations.size() / 16;
+  return count;
+}
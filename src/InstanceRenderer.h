@@ -0,0 +1,40 @@
+/**
+ * Copyright Jan-Philipp Kappmeier, Melanie Schmidt
+ * \file	InstanceRenderer.h
+ * \brief	Declares a renderer that draws all ships using the same model together.
+ */
+#pragma once
+
+#include "GlobalGL.h"
+#include <vector>
+
+class Mesh;
+class SpaceShip;
+
+/**
+ * \brief Collects the visible ships of a frame and draws them grouped by their mesh.
+ *
+ * Pirates, police ships and thargoids each share one model, so the state and
+ * the vertex buffers are set up only once for each model type. The
+ * transformations of the ships are computed on the CPU and stored in one
+ * array per model, the instances are then drawn with Mesh::drawInstances().
+ * The arrays keep their memory, so after the first frames no more
+ * allocations are necessary.
+ */
+class InstanceRenderer {
+public:
+  InstanceRenderer( void );
+  ~InstanceRenderer( void );
+
+  void clear( void );
+  void add( SpaceShip * ship );
+  void draw( void );
+  unsigned int getInstanceCount( void );
+private:
+  //! All instances of one mesh.
+  struct Group {
+    Mesh *mesh;
+    std::vector<GLfloat> transformations;
+  };
+  std::vector<Group> groups;
+};
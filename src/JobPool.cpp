@@ -0,0 +1,229 @@
+/**
+ * Copyright Jan-Philipp Kappmeier, Melanie Schmidt
+ * \file	JobPool.cpp
+ * \brief	Implementation of the job pool.
+ */
+#include "JobPool.h"
+
+using namespace std;
+
+// the maximal number of worker threads, the calling thread works, too
+static const unsigned int maxWorkers = 15;
+
+/**
+ * \brief Sets up an empty pool. The threads are started when the first jobs are run.
+ */
+JobPool::JobPool( void ) {
+  ranges = 0;
+  workers = 0;
+  workerCount = 0;
+  started = false;
+  stopping = false;
+  job = 0;
+  context = 0;
+#ifndef MELITE_HEADLESS
+  threads = 0;
+  wakeUp = 0;
+  finished = NULL;
+  active = 0;
+#else
+  generation = 0;
+  active = 0;
+#endif
+}
+
+/**
+ * \brief Stops the worker threads and waits until they have exited.
+ */
+JobPool::~JobPool( void ) {
+#ifndef MELITE_HEADLESS
+  stopping = true;
+  for( unsigned int i = 0; i < workerCount; i++ )
+    SetEvent( wakeUp[i] );
+  if( workerCount > 0 )
+    WaitForMultipleObjects( workerCount, threads, TRUE, INFINITE );
+  for( unsigned int i = 0; i < workerCount; i++ ) {
+    CloseHandle( threads[i] );
+    CloseHandle( wakeUp[i] );
+  }
+  if( finished != NULL )
+    CloseHandle( finished );
+  delete [] threads;
+  delete [] wakeUp;
+#else
+  {
+    lock_guard<mutex> guard( lock );
+    stopping = true;
+  }
+  wakeUp.notify_all();
+  for( unsigned int i = 0; i < threads.size(); i++ )
+    threads[i].join();
+#endif
+  delete [] workers;
+  delete [] ranges;
+}
+
+//! Runs jobs in parallel and waits until all of them are finished.
+/**
+ * \param job the function that is called for each job
+ * \param context passed to each job
+ * \param count the number of jobs, they get the numbers 0 to count - 1
+ */
+void JobPool::run( Job job, void *context, unsigned int count ) {
+  if( count == 0 )
+    return;
+  start();
+  this->job = job;
+  this->context = context;
+  unsigned int parts = workerCount + 1;
+  for( unsigned int i = 0; i < parts; i++ ) {
+    ranges[i].next = (long)( (unsigned long long)count * i / parts );
+    ranges[i].end = (long)( (unsigned long long)count * (i + 1) / parts );
+  }
+  if( workerCount == 0 ) {
+    work( 0 );
+    return;
+  }
+
+#ifndef MELITE_HEADLESS
+  active = workerCount;
+  ResetEvent( finished );
+  for( unsigned int i = 0; i < workerCount; i++ )
+    SetEvent( wakeUp[i] );
+  work( 0 );
+  WaitForSingleObject( finished, INFINITE );
+#else
+  {
+    lock_guard<mutex> guard( lock );
+    active = workerCount;
+    generation++;
+  }
+  wakeUp.notify_all();
+  work( 0 );
+  unique_lock<mutex> guard( lock );
+  while( active > 0 )
+    finished.wait( guard );
+#endif
+}
+
+/**
+ * \brief Returns the number of worker threads, without the calling thread. Zero before the first jobs are run.
+ */
+unsigned int JobPool::getWorkerCount( void ) {
+  return workerCount;
+}
+
+//! Starts one worker for each processor core except one, which is used by the calling thread.
+/**
+ * If a thread can not be started, the pool works with less threads.
+ */
+void JobPool::start( void ) {
+  if( started )
+    return;
+  started = true;
+#ifndef MELITE_HEADLESS
+  SYSTEM_INFO info;
+  GetSystemInfo( &info );
+  unsigned int cores = (unsigned int)info.dwNumberOfProcessors;
+#else
+  unsigned int cores = thread::hardware_concurrency();
+#endif
+  unsigned int count = cores > 1 ? min( cores - 1, maxWorkers ) : 0;
+  ranges = new Range[count + 1];
+  workers = new Worker[count];
+
+#ifndef MELITE_HEADLESS
+  threads = new HANDLE[count];
+  wakeUp = new HANDLE[count];
+  finished = CreateEvent( NULL, TRUE, FALSE, NULL );
+  for( unsigned int i = 0; i < count && finished != NULL; i++ ) {
+    workers[workerCount].pool = this;
+    workers[workerCount].index = workerCount;
+    wakeUp[workerCount] = CreateEvent( NULL, FALSE, FALSE, NULL );
+    if( wakeUp[workerCount] == NULL )
+      break;
+    threads[workerCount] = CreateThread( NULL, 0, runWorker, &workers[workerCount], 0, NULL );
+    if( threads[workerCount] == NULL ) {
+      CloseHandle( wakeUp[workerCount] );
+      break;
+    }
+    workerCount++;
+  }
+#else
+  for( unsigned int i = 0; i < count; i++ ) {
+    workers[i].pool = this;
+    workers[i].index = i;
+    threads.push_back( thread( &JobPool::loop, this, i ) );
+  }
+  workerCount = count;
+#endif
+}
+
+//! Runs jobs until all ranges are empty.
+/**
+ * The thread begins with its own range, then it steals from the following ones.
+ * \param range the own range of the thread
+ */
+void JobPool::work( unsigned int range ) {
+  unsigned int parts = workerCount + 1;
+  for( unsigned int i = 0; i < parts; i++ ) {
+    Range &r = ranges[(range + i) % parts];
+    while( true ) {
+#ifndef MELITE_HEADLESS
+      long index = InterlockedIncrement( &r.next ) - 1;
+#else
+      long index = r.next++;
+#endif
+      if( index >= r.end )
+        break;
+      job( context, (unsigned int)index );
+    }
+  }
+}
+
+#ifndef MELITE_HEADLESS
+/**
+ * \brief The entry point of the worker threads.
+ * \param parameter the Worker structure of the thread
+ */
+DWORD WINAPI JobPool::runWorker( LPVOID parameter ) {
+  Worker *worker = static_cast<Worker*>( parameter );
+  worker->pool->loop( worker->index );
+  return 0;
+}
+#endif
+
+//! The main loop of a worker thread.
+/**
+ * The worker sleeps until run() wakes it up, works on its range and the ranges of
+ * the others and tells run() when it is finished.
+ * \param worker the number of the worker, its range is the following one
+ */
+void JobPool::loop( unsigned int worker ) {
+#ifndef MELITE_HEADLESS
+  while( true ) {
+    WaitForSingleObject( wakeUp[worker], INFINITE );
+    if( stopping )
+      return;
+    work( worker + 1 );
+    if( InterlockedDecrement( &active ) == 0 )
+      SetEvent( finished );
+  }
+#else
+  unsigned int seen = 0;
+  while( true ) {
+    {
+      unique_lock<mutex> guard( lock );
+      while( !stopping && generation == seen )
+        wakeUp.wait( guard );
+      if( stopping )
+        return;
+      seen = generation;
+    }
+    work( worker + 1 );
+    lock_guard<mutex> guard( lock );
+    if( --active == 0 )
+      finished.notify_one();
+  }
+#endif
+}
@@ -0,0 +1,83 @@
+/**
+ * Copyright Jan-Philipp Kappmeier, Melanie Schmidt
+ * \file	JobPool.h
+ * \brief	Declares the JobPool, a set of worker threads that run independent jobs in parallel.
+ */
+#pragma once
+
+#include "GlobalGL.h"
+#ifdef MELITE_HEADLESS
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#endif
+
+//! Runs a number of jobs on all processor cores.
+/**
+ * The worker threads are started with the first call of run() and wait between two
+ * calls. The jobs of a call are numbered and divided into one range for each worker
+ * and one for the calling thread, which works, too. Each thread takes the jobs of its
+ * own range. If it is finished, it steals the remaining jobs of the other ranges. A job
+ * is taken by increasing the counter of its range atomically, so no locks are needed.
+ * run() returns after all jobs are finished.
+ *
+ * The jobs must not depend on each other, their order is undefined. The game uses
+ * Win32 threads, the headless build the threads of the standard library.
+ */
+class JobPool {
+public:
+  //! A job, called with the context given to run() and the number of the job.
+  typedef void (*Job)( void *context, unsigned int index );
+
+  JobPool( void );
+  ~JobPool( void );
+  void run( Job job, void *context, unsigned int count );
+  unsigned int getWorkerCount( void );
+private:
+  void start( void );
+  void work( unsigned int range );
+#ifndef MELITE_HEADLESS
+  static DWORD WINAPI runWorker( LPVOID parameter );
+#endif
+  void loop( unsigned int worker );
+
+#ifndef MELITE_HEADLESS
+  typedef volatile LONG Counter;
+#else
+  typedef std::atomic<long> Counter;
+#endif
+  //! The jobs assigned to a thread, padded to its own cache line.
+  struct Range {
+    Counter next;                     // the next job that is taken
+    long end;
+    char padding[64 - sizeof( Counter ) - sizeof( long )];
+  };
+  //! The parameters given to a worker thread.
+  struct Worker {
+    JobPool *pool;
+    unsigned int index;
+  };
+
+  Range *ranges;                      // the first range belongs to the calling thread
+  Worker *workers;
+  unsigned int workerCount;
+  bool started;
+  bool stopping;
+  Job job;
+  void *context;
+#ifndef MELITE_HEADLESS
+  HANDLE *threads;
+  HANDLE *wakeUp;                     // one event for each worker, set if jobs are available
+  HANDLE finished;                    // set by the last worker that is finished
+  volatile LONG active;               // the workers that are still working
+#else
+  std::vector<std::thread> threads;
+  std::mutex lock;
+  std::condition_variable wakeUp;
+  std::condition_variable finished;
+  unsigned int generation;            // increased with each call of run()
+  unsigned int active;
+#endif
+};
@@ -0,0 +1,130 @@
+/**
+ * Copyright Jan-Philipp Kappmeier, Melanie Schmidt
+ * \file	MappedFile.cpp
+ * \brief	Implementation of the memory mapped file.
+ */
+#include "MappedFile.h"
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile( void ) : data( 0 ), size( 0 ) {
+#ifdef _WIN32
+  file = INVALID_HANDLE_VALUE;
+  mapping = 0;
+#endif
+}
+
+MappedFile::~MappedFile( void ) {
+  close();
+}
+
+//! Maps a file into memory.
+/**
+ * An empty file can not be mapped and is treated as an error.
+ * \param filename the file
+ * \return true, if the file could be mapped
+ */
+bool MappedFile::open( const std::string &filename ) {
+  close();
+#ifdef _WIN32
+  file = CreateFileA( filename.c_str(), GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0 );
+  if( file == INVALID_HANDLE_VALUE )
+    return false;
+  DWORD length = GetFileSize( file, 0 );
+  if( length == 0 || length == INVALID_FILE_SIZE ) {
+    close();
+    return false;
+  }
+  mapping = CreateFileMappingA( file, 0, PAGE_READONLY, 0, 0, 0 );
+  if( mapping == 0 ) {
+    close();
+    return false;
+  }
+  data = (const unsigned char *)MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 );
+  if( data == 0 ) {
+    close();
+    return false;
+  }
+  size = length;
+#else
+  int fd = ::open( filename.c_str(), O_RDONLY );
+  if( fd < 0 )
+    return false;
+  struct stat info;
+  if( fstat( fd, &info ) != 0 || info.st_size == 0 ) {
+    ::close( fd );
+    return false;
+  }
+  void *view = mmap( 0, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+  ::close( fd ); // the mapping keeps the file open
+  if( view == MAP_FAILED )
+    return false;
+  data = (const unsigned char *)view;
+  size = info.st_size;
+#endif
+  return true;
+}
+
+/**
+ * \brief Removes the mapping and closes the file.
+ */
+void MappedFile::close( void ) {
+#ifdef _WIN32
+  if( data != 0 )
+    UnmapViewOfFile( data );
+  if( mapping != 0 )
+    CloseHandle( mapping );
+  if( file != INVALID_HANDLE_VALUE )
+    CloseHandle( file );
+  mapping = 0;
+  file = INVALID_HANDLE_VALUE;
+#else
+  if( data != 0 )
+    munmap( (void *)data, size );
+#endif
+  data = 0;
+  size = 0;
+}
+
+/**
+ * \brief Returns true, if a file is mapped.
+ */
+bool MappedFile::isOpen( void ) {
+  return data != 0;
+}
+
+/**
+ * \brief Returns the contents of the file, or null if no file is mapped.
+ */
+const unsigned char * MappedFile::getData( void ) {
+  return data;
+}
+
+/**
+ * \brief Returns the size of the file in bytes.
+ */
+size_t MappedFile::getSize( void ) {
+  return size;
+}
+
+//! Computes the 32 bit FNV-1a hash of a block of memory.
+/**
+ * The hash of several blocks can be computed by passing the result of the
+ * previous block as seed.
+ * \param data the memory
+ * \param size the number of bytes
+ * \param seed the start value, the default is the FNV offset basis
+ * \return the hash value
+ */
+unsigned int MappedFile::hash( const unsigned char *data, size_t size, unsigned int seed ) {
+  unsigned int h = seed;
+  for( size_t i = 0; i < size; i++ ) {
+    h ^= data[i];
+    h *= 16777619u;
+  }
+  return h;
+}
@@ -0,0 +1,39 @@
+/**
+ * Copyright Jan-Philipp Kappmeier, Melanie Schmidt
+ * \file	MappedFile.h
+ * \brief	Declares a read only file that is mapped into memory.
+ */
+#pragma once
+
+#include "GlobalGL.h"
+#include <string>
+
+//! A file that is mapped into the address space for reading.
+/**
+ * The contents are available through getData() without copying them into a
+ * buffer, the operating system loads the pages when they are accessed. The
+ * mapping is removed when the object is destroyed.
+ */
+class MappedFile {
+public:
+  MappedFile( void );
+  ~MappedFile( void );
+
+  bool open( const std::string &filename );
+  void close( void );
+  bool isOpen( void );
+  const unsigned char * getData( void );
+  size_t getSize( void );
+
+  static unsigned int hash( const unsigned char *data, size_t size, unsigned int seed = 2166136261u );
+private:
+  MappedFile( const MappedFile & );
+  MappedFile & operator =( const MappedFile & );
+
+  const unsigned char *data;
+  size_t size;
+#ifdef _WIN32
+  HANDLE file;
+  HANDLE mapping;
+#endif
+};
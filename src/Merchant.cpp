@@ -5,7 +5,7 @@
  */
 #include "Merchant.h"
 
-Merchant::Merchant(float r, GLuint displayList, Planet * planet, Vector3 aim):ForeignSpaceShip(r,displayList)
+Merchant::Merchant(float r, Mesh *mesh, Planet * planet, Vector3 aim):ForeignSpaceShip(r,mesh)
 {
 	this->planet=planet;
 	this->aim = aim;
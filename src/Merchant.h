@@ -4,7 +4,7 @@
  * \brief Declaration of a Merchant space ship.
  */
 #pragma once
-#include "foreignspaceship.h"
+#include "ForeignSpaceShip.h"
 #include "Planet.h"
 
 //! A Merchant is a specific space ship that travels between a planet and the station.
@@ -12,7 +12,7 @@ class Merchant :
 	public ForeignSpaceShip
 {
 public:
-	Merchant(float r, GLuint displayList, Planet * planet, Vector3 aim);
+	Merchant(float r, Mesh *mesh, Planet * planet, Vector3 aim);
 public:
 	~Merchant(void);
 public:
@@ -0,0 +1,352 @@
+/**
+ * Copyright Jan-Philipp Kappmeier, Melanie Schmidt
+ * \file	Mesh.cpp
+ * \brief	Implementation of the triangle mesh that is stored in vertex and index buffers.
+ */
+#include "Mesh.h"
+#include "ObjectLoader3ds.h"
+#include "VectorMath.h"
+#include "MappedFile.h"
+#include <map>
+#include <cstddef>
+#include <cstring>
+
+using namespace std;
+
+// vertex buffer objects are part of OpenGL 1.5, the windows headers only support version 1.1
+#ifndef GL_ARRAY_BUFFER
+#define GL_ARRAY_BUFFER 0x8892
+#define GL_ELEMENT_ARRAY_BUFFER 0x8893
+#define GL_STATIC_DRAW 0x88E4
+#endif
+
+typedef void (APIENTRY * BindBufferFunction)( GLenum target, GLuint buffer );
+typedef void (APIENTRY * GenBuffersFunction)( GLsizei n, GLuint *buffers );
+typedef void (APIENTRY * DeleteBuffersFunction)( GLsizei n, const GLuint *buffers );
+typedef void (APIENTRY * BufferDataFunction)( GLenum target, ptrdiff_t size, const GLvoid *data, GLenum usage );
+
+static BindBufferFunction bindBuffer = 0;
+static GenBuffersFunction genBuffers = 0;
+static DeleteBuffersFunction deleteBuffers = 0;
+static BufferDataFunction bufferData = 0;
+static bool bufferFunctionsLoaded = false;
+
+// the version of the cache files, has to be increased if the layout changes
+static const unsigned int cacheVersion = 1;
+static const char cacheMagic[4] = { 'M', 'M', 'S', 'H' };
+
+//! Gets the addresses of the vertex buffer functions from the driver.
+/**
+ * The addresses are only available if a rendering context exists, so they are
+ * loaded when the first mesh is uploaded.
+ * \return true, if vertex buffer objects are supported
+ */
+static bool loadBufferFunctions( void ) {
+  if( !bufferFunctionsLoaded ) {
+    bindBuffer = (BindBufferFunction)wglGetProcAddress( "glBindBuffer" );
+    genBuffers = (GenBuffersFunction)wglGetProcAddress( "glGenBuffers" );
+    deleteBuffers = (DeleteBuffersFunction)wglGetProcAddress( "glDeleteBuffers" );
+    bufferData = (BufferDataFunction)wglGetProcAddress( "glBufferData" );
+    bufferFunctionsLoaded = true;
+  }
+  return bindBuffer && genBuffers && deleteBuffers && bufferData;
+}
+
+/**
+ * \brief Compares two vertices bytewise. Used to find vertices that can be shared by triangles.
+ */
+bool Mesh::Vertex::operator <( const Vertex &v ) const {
+  return memcmp( this, &v, sizeof( Vertex ) ) < 0;
+}
+
+//! Converts all meshes of a loaded model into one vertex and one index array.
+/**
+ * Each triangle gets the normal of its plane and the diffuse color of its material,
+ * the positions are scaled only once. Vertices that are equal in position, normal
+ * and color are stored only once. The indices are sorted by the material of the
+ * triangles, the triangles of each material form one batch. Triangles with an
+ * invalid material are collected in a last batch and drawn white.
+ * \param model the model, contains mesh data
+ * \param factor a factor that scales the model size
+ */
+Mesh::Mesh( ObjectLoader3ds * model, float factor ) {
+  vertexBuffer = 0;
+  indexBuffer = 0;
+  indexData = 0;
+  uploaded = false;
+
+  unsigned int materialCount = model->materialList.size();
+  vector< vector<GLuint> > materialIndices( materialCount + 1 );
+  map<Vertex, GLuint> known;
+
+  for( int i = 0; i < model->totalMeshes; i++ ) {
+    stMesh *pMesh = &model->meshList[i];
+    if( !pMesh->pFaces || !pMesh->pVertices )
+      continue;
+
+    for( unsigned int f = 0; f < pMesh->totalFaces; f++ ) {
+      stFace *pFace = &pMesh->pFaces[f];
+
+      unsigned int material = materialCount;
+      Vertex v;
+      v.color[0] = v.color[1] = v.color[2] = 1;
+      if( pFace->matId >= 0 && (unsigned int)pFace->matId < materialCount ) {
+        material = pFace->matId;
+        stMaterial *pMaterial = &model->materialList[material];
+        v.color[0] = (float)pMaterial->colorDiffuse.r / 255.0f;
+        v.color[1] = (float)pMaterial->colorDiffuse.g / 255.0f;
+        v.color[2] = (float)pMaterial->colorDiffuse.b / 255.0f;
+      }
+
+      Vector3 p[3];
+      for( unsigned int k = 0; k < 3; k++ ) {
+        stVertex *pVertex = &pMesh->pVertices[pFace->indices[k]];
+        p[k] = Vector3( pVertex->x * factor, pVertex->y * factor, pVertex->z * factor );
+      }
+      Vector3 normal = VectorMath::normal( p[0], p[1], p[2] );
+      v.normal[0] = normal.x;
+      v.normal[1] = normal.y;
+      v.normal[2] = normal.z;
+
+      for( unsigned int k = 0; k < 3; k++ ) {
+        v.pos[0] = p[k].x;
+        v.pos[1] = p[k].y;
+        v.pos[2] = p[k].z;
+        map<Vertex, GLuint>::iterator it = known.find( v );
+        GLuint index;
+        if( it == known.end() ) {
+          index = (GLuint)vertices.size();
+          vertices.push_back( v );
+          known[v] = index;
+        } else
+          index = it->second;
+        materialIndices[material].push_back( index );
+      }
+    }
+  }
+
+  for( unsigned int m = 0; m < materialIndices.size(); m++ ) {
+    if( materialIndices[m].empty() )
+      continue;
+    Batch b;
+    b.first = (unsigned int)indices.size();
+    b.count = (unsigned int)materialIndices[m].size();
+    indices.insert( indices.end(), materialIndices[m].begin(), materialIndices[m].end() );
+    batches.push_back( b );
+  }
+}
+
+/**
+ * \brief Creates an empty mesh, which is filled by loadCache().
+ */
+Mesh::Mesh( void ) {
+  vertexBuffer = 0;
+  indexBuffer = 0;
+  indexData = 0;
+  uploaded = false;
+}
+
+//! Loads a mesh from a cache file written by saveCache().
+/**
+ * The file is mapped into memory, the arrays are copied as they are. The cache
+ * is only used if it has the current version and was written with the same key,
+ * otherwise it is outdated.
+ * \param filename the cache file
+ * \param key identifies the source of the mesh, e. g. a hash of the model file
+ * \return the mesh, or null if the cache does not exist or is outdated
+ */
+Mesh * Mesh::loadCache( const std::string &filename, unsigned int key ) {
+  MappedFile file;
+  if( !file.open( filename ) || file.getSize() < sizeof( CacheHeader ) )
+    return 0;
+  const unsigned char *data = file.getData();
+  const CacheHeader *header = (const CacheHeader *)data;
+  if( memcmp( header->magic, cacheMagic, 4 ) != 0 || header->version != cacheVersion || header->key != key ||
+      header->vertexSize != sizeof( Vertex ) )
+    return 0;
+  size_t vertexBytes = header->vertexCount * sizeof( Vertex );
+  size_t indexBytes = header->indexCount * sizeof( GLuint );
+  size_t batchBytes = header->batchCount * sizeof( Batch );
+  if( file.getSize() != sizeof( CacheHeader ) + vertexBytes + indexBytes + batchBytes )
+    return 0;
+
+  Mesh *mesh = new Mesh();
+  const Vertex *v = (const Vertex *)(data + sizeof( CacheHeader ));
+  const GLuint *i = (const GLuint *)(data + sizeof( CacheHeader ) + vertexBytes);
+  const Batch *b = (const Batch *)(data + sizeof( CacheHeader ) + vertexBytes + indexBytes);
+  mesh->vertices.assign( v, v + header->vertexCount );
+  mesh->indices.assign( i, i + header->indexCount );
+  mesh->batches.assign( b, b + header->batchCount );
+  return mesh;
+}
+
+//! Writes the arrays of the mesh into a cache file.
+/**
+ * \param filename the cache file, is overwritten
+ * \param key identifies the source of the mesh, is checked by loadCache()
+ * \return true, if the file was written completely
+ */
+bool Mesh::saveCache( const std::string &filename, unsigned int key ) {
+  FILE *file = 0;
+  fopen_s( &file, filename.c_str(), "wb" );
+  if( !file )
+    return false;
+  CacheHeader header;
+  memcpy( header.magic, cacheMagic, 4 );
+  header.version = cacheVersion;
+  header.key = key;
+  header.vertexSize = sizeof( Vertex );
+  header.vertexCount = (unsigned int)vertices.size();
+  header.indexCount = (unsigned int)indices.size();
+  header.batchCount = (unsigned int)batches.size();
+  bool written = fwrite( &header, sizeof( CacheHeader ), 1, file ) == 1;
+  if( written && !vertices.empty() )
+    written = fwrite( &vertices[0], sizeof( Vertex ), vertices.size(), file ) == vertices.size();
+  if( written && !indices.empty() )
+    written = fwrite( &indices[0], sizeof( GLuint ), indices.size(), file ) == indices.size();
+  if( written && !batches.empty() )
+    written = fwrite( &batches[0], sizeof( Batch ), batches.size(), file ) == batches.size();
+  fclose( file );
+  if( !written )
+    remove( filename.c_str() ); // an incomplete cache is rejected by loadCache() anyway
+  return written;
+}
+
+/**
+ * \brief Destructor, frees the buffers on the graphics card if the mesh was uploaded.
+ */
+Mesh::~Mesh( void ) {
+  if( uploaded ) {
+    deleteBuffers( 1, &vertexBuffer );
+    deleteBuffers( 1, &indexBuffer );
+  }
+}
+
+//! Copies the vertex and index arrays into vertex buffer objects.
+/**
+ * Needs a rendering context. If vertex buffer objects are not supported, nothing
+ * happens and the mesh is drawn from the arrays in main memory.
+ */
+void Mesh::upload( void ) {
+  if( uploaded || indices.empty() || !loadBufferFunctions() )
+    return;
+
+  genBuffers( 1, &vertexBuffer );
+  bindBuffer( GL_ARRAY_BUFFER, vertexBuffer );
+  bufferData( GL_ARRAY_BUFFER, vertices.size() * sizeof( Vertex ), &vertices[0], GL_STATIC_DRAW );
+  bindBuffer( GL_ARRAY_BUFFER, 0 );
+
+  genBuffers( 1, &indexBuffer );
+  bindBuffer( GL_ELEMENT_ARRAY_BUFFER, indexBuffer );
+  bufferData( GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof( GLuint ), &indices[0], GL_STATIC_DRAW );
+  bindBuffer( GL_ELEMENT_ARRAY_BUFFER, 0 );
+
+  uploaded = true;
+}
+
+//! Draws the mesh.
+/**
+ * Sets up the same material state the display lists used before, the color is
+ * taken from the vertices. Then each batch is drawn with one call.
+ */
+void Mesh::draw( void ) {
+  if( indices.empty() )
+    return;
+  beginDraw();
+  drawBatches();
+  endDraw();
+}
+
+//! Draws the mesh several times at different positions.
+/**
+ * The state and the arrays are set up only once for all instances, for each
+ * instance only the transformation is multiplied onto the modelview matrix
+ * before the batches are drawn.
+ * \param transformations the matrices of the instances, 16 values for each instance
+ * in the column major order used by glMultMatrixf
+ * \param count the number of instances
+ */
+void Mesh::drawInstances( const GLfloat * transformations, unsigned int count ) {
+  if( indices.empty() || count == 0 )
+    return;
+  beginDraw();
+  for( unsigned int i = 0; i < count; i++ ) {
+    glPushMatrix();
+    glMultMatrixf( transformations + 16*i );
+    drawBatches();
+    glPopMatrix();
+  }
+  endDraw();
+}
+
+/**
+ * \brief Sets up the material state and the vertex arrays.
+ */
+void Mesh::beginDraw( void ) {
+  glPushAttrib( GL_ALL_ATTRIB_BITS );
+  glPushClientAttrib( GL_CLIENT_VERTEX_ARRAY_BIT );
+  glColorMaterial( GL_FRONT, GL_AMBIENT_AND_DIFFUSE );
+  glEnable( GL_COLOR_MATERIAL );
+  glDisable( GL_TEXTURE_2D );
+  float specular[] = {1,0,0,1};
+  glMaterialfv( GL_FRONT, GL_SPECULAR, specular );
+
+  // with buffer objects the pointers are offsets into the buffers
+  const GLubyte *vertexData = 0;
+  indexData = 0;
+  if( uploaded ) {
+    bindBuffer( GL_ARRAY_BUFFER, vertexBuffer );
+    bindBuffer( GL_ELEMENT_ARRAY_BUFFER, indexBuffer );
+  } else {
+    vertexData = (const GLubyte *)&vertices[0];
+    indexData = (const GLubyte *)&indices[0];
+  }
+
+  glEnableClientState( GL_VERTEX_ARRAY );
+  glEnableClientState( GL_NORMAL_ARRAY );
+  glEnableClientState( GL_COLOR_ARRAY );
+  glVertexPointer( 3, GL_FLOAT, sizeof( Vertex ), vertexData + offsetof( Vertex, pos ) );
+  glNormalPointer( GL_FLOAT, sizeof( Vertex ), vertexData + offsetof( Vertex, normal ) );
+  glColorPointer( 3, GL_FLOAT, sizeof( Vertex ), vertexData + offsetof( Vertex, color ) );
+}
+
+/**
+ * \brief Draws all batches with the current modelview matrix, one call for each material.
+ */
+void Mesh::drawBatches( void ) {
+  for( unsigned int i = 0; i < batches.size(); i++ )
+    glDrawElements( GL_TRIANGLES, batches[i].count, GL_UNSIGNED_INT, indexData + batches[i].first * sizeof( GLuint ) );
+}
+
+/**
+ * \brief Unbinds the buffers and restores the state.
+ */
+void Mesh::endDraw( void ) {
+  if( uploaded ) {
+    bindBuffer( GL_ARRAY_BUFFER, 0 );
+    bindBuffer( GL_ELEMENT_ARRAY_BUFFER, 0 );
+  }
+  glPopClientAttrib();
+  glPopAttrib();
+}
+
+/**
+ * \brief Returns the number of batches, which is the number of draw calls for the mesh.
+ */
+unsigned int Mesh::getBatchCount( void ) {
+  return (unsigned int)batches.size();
+}
+
+/**
+ * \brief Returns the number of different vertices.
+ */
+unsigned int Mesh::getVertexCount( void ) {
+  return (unsigned int)vertices.size();
+}
+
+/**
+ * \brief Returns the number of indices, that is three times the number of triangles.
+ */
+unsigned int Mesh::getIndexCount( void ) {
+  return (unsigned int)indices.size();
+}
@@ -0,0 +1,79 @@
+/**
+ * Copyright Jan-Philipp Kappmeier, Melanie Schmidt
+ * \file	Mesh.h
+ * \brief	Declares a triangle mesh that is stored in vertex and index buffers.
+ */
+#pragma once
+
+#include "GlobalGL.h"
+#include <vector>
+#include <string>
+
+class ObjectLoader3ds;
+
+/**
+ * \brief A triangle mesh that is drawn from vertex arrays.
+ *
+ * The meshes of a loaded model are converted into one interleaved vertex array
+ * containing position, normal and color and one array of 32 bit indices. The
+ * triangles are sorted by their material, so the mesh is drawn with one call
+ * of glDrawElements for each material. If vertex buffer objects are supported,
+ * both arrays are uploaded to the graphics card, otherwise they are used as
+ * client side arrays.
+ *
+ * The converted arrays can be stored in a binary cache file, which is mapped
+ * into memory and copied into the arrays when the model is loaded again. So
+ * the model file has not to be parsed and no normals have to be computed.
+ */
+class Mesh {
+public:
+  Mesh( ObjectLoader3ds * model, float factor );
+  ~Mesh( void );
+
+  static Mesh * loadCache( const std::string &filename, unsigned int key );
+  bool saveCache( const std::string &filename, unsigned int key );
+
+  void upload( void );
+  void draw( void );
+  void drawInstances( const GLfloat * transformations, unsigned int count );
+
+  unsigned int getBatchCount( void );
+  unsigned int getVertexCount( void );
+  unsigned int getIndexCount( void );
+private:
+  Mesh( void );
+  void beginDraw( void );
+  void drawBatches( void );
+  void endDraw( void );
+
+  //! A vertex in the interleaved vertex array.
+  struct Vertex {
+    GLfloat pos[3];
+    GLfloat normal[3];
+    GLfloat color[3];
+    bool operator <( const Vertex &v ) const;
+  };
+  //! The triangles of one material, given by a range in the index array.
+  struct Batch {
+    unsigned int first;
+    unsigned int count;
+  };
+  //! The header of a cache file, followed by the vertices, the indices and the batches.
+  struct CacheHeader {
+    char magic[4];
+    unsigned int version;
+    unsigned int key;
+    unsigned int vertexSize;
+    unsigned int vertexCount;
+    unsigned int indexCount;
+    unsigned int batchCount;
+  };
+
+  std::vector<Vertex> vertices;
+  std::vector<GLuint> indices;
+  std::vector<Batch> batches;
+  GLuint vertexBuffer;
+  GLuint indexBuffer;
+  const GLubyte *indexData;
+  bool uploaded;
+};
@@ -5,20 +5,23 @@
  *        3d model based on triangles.
  */
 #include "ModelObject.h"
+#ifndef MELITE_HEADLESS
+#include "Mesh.h"
+#endif
 
 /**
  * \brief Creates a model object.
  */
 ModelObject::ModelObject( void ) : GraphicsObject() {
-  m_list = 0;
+  m_mesh = 0;
 }
 
 /**
  * \brief Creates a model object and sets up the display List.
- * \param displayList The display list number returned by OpenGL
+ * \param mesh The mesh that is drawn
  */
-ModelObject::ModelObject( GLuint displayList ) : GraphicsObject() {
-  m_list = displayList;
+ModelObject::ModelObject( Mesh *mesh ) : GraphicsObject() {
+  m_mesh = mesh;
 }
 
 /**
@@ -26,16 +29,16 @@ ModelObject::ModelObject( GLuint displayList ) : GraphicsObject() {
  * \param r The object radius
  */
 ModelObject::ModelObject( float r ) : GraphicsObject( r ) {
-  m_list = 0;
+  m_mesh = 0;
 }
 
 /**
  * \brief Creates a model object and sets up the display List.
  * \param r The object radius
- * \param displayList The display list number returned by OpenGL 
+ * \param mesh The mesh that is drawn 
  */
-ModelObject::ModelObject( float r, GLuint displayList ) : GraphicsObject( r ) {
-  m_list = displayList;
+ModelObject::ModelObject( float r, Mesh *mesh ) : GraphicsObject( r ) {
+  m_mesh = mesh;
 }
 
 /**
@@ -44,29 +47,29 @@ ModelObject::ModelObject( float r, GLuint displayList ) : GraphicsObject( r ) {
  * \param r The object radius
  */
 ModelObject::ModelObject( Vector3 position, float r ) : GraphicsObject( position, r ) {
-  m_list = 0;
+  m_mesh = 0;
 }
 
 /**
  * \brief Creates a model object and sets up the display List.
  * \param position The position as Vector3
  * \param r The object radius
- * \param displayList The display list number returned by OpenGL 
+ * \param mesh The mesh that is drawn 
  */
-ModelObject::ModelObject( Vector3 position, float r, GLuint displayList) : GraphicsObject( position, r ) {
-  m_list = displayList;
+ModelObject::ModelObject( Vector3 position, float r, Mesh *mesh) : GraphicsObject( position, r ) {
+  m_mesh = mesh;
 }
 
 //! \brief Creates a model object.
 /**
- * The display list is not provided so the constructor is private.
+ * The mesh is not provided so the constructor is private.
  * \param x The x-position
  * \param y The y-position
  * \param z The z-position
  * \param r The object radius
  */
 ModelObject::ModelObject( float x, float y, float z, float r ) : GraphicsObject( x, y, z, r ) {
-  m_list = 0;
+  m_mesh = 0;
 }
 
 /**
@@ -75,10 +78,10 @@ ModelObject::ModelObject( float x, float y, float z, float r ) : GraphicsObject(
  * \param y The y-position
  * \param z The z-position
  * \param r The object radius
- * \param displayList The display list number returned by OpenGL 
+ * \param mesh The mesh that is drawn 
  */
-ModelObject::ModelObject( float x, float y, float z, float r, GLuint displayList) : GraphicsObject( x, y, z, r ) {
-  m_list = displayList;
+ModelObject::ModelObject( float x, float y, float z, float r, Mesh *mesh) : GraphicsObject( x, y, z, r ) {
+  m_mesh = mesh;
 }
 
 /**
@@ -89,11 +92,21 @@ ModelObject::~ModelObject( void ) {
 
 //! Draws the object.
 /**
- * Draws the object using the display list. Therefore no textur and color information is needed. All
- * actions that are necessary to draw the object should take place in the list. It is possible to
+ * Draws the object using the mesh. Therefore no textur and color information is needed. All
+ * actions that are necessary to draw the object are done by the mesh. It is possible to
  * create a derived class that does something else and calls this draw() method to draw the model.
  * \sa SpaceStation::draw() where this function is combined with a spinning object.
  */
 void ModelObject::draw() {
-  glCallList( m_list );
-}
\ No newline at end of file
+#ifndef MELITE_HEADLESS
+  if( m_mesh )
+    m_mesh->draw();
+#endif
+}
+
+/**
+ * \brief Returns the mesh that is used to draw the object.
+ */
+Mesh * ModelObject::getMesh( void ) {
+  return m_mesh;
+}
@@ -9,21 +9,23 @@
 #include "GraphicsObject.h"
 #include "Vector3.h"
 
+class Mesh;
+
 //! A real drawing class that can render triangle mesh net based objects. 
 /**
  * It's derived from the abstract 
- * GraphicsObject and implements the draw() method. A display list has to be 
- * submitted to this class and this display list is executed each time the 
+ * GraphicsObject and implements the draw() method. A mesh has to be 
+ * submitted to this class and this mesh is drawn each time the 
  * draw method is called. Therefore no color, texture and other information is
  * needed.
  */
 class ModelObject : public GraphicsObject {
-  // constructors, a display list has to be submitted to the constructor
+  // constructors, a mesh has to be submitted to the constructor
 public:
-  ModelObject( GLuint displayList );
-  ModelObject( float r, GLuint displayList );
-  ModelObject( Vector3 position, float r, GLuint displayList);
-  ModelObject( float x, float y, float z, float r, GLuint displayList);
+  ModelObject( Mesh *mesh );
+  ModelObject( float r, Mesh *mesh );
+  ModelObject( Vector3 position, float r, Mesh *mesh);
+  ModelObject( float x, float y, float z, float r, Mesh *mesh);
   ~ModelObject( void );
 private:
   ModelObject( void );
@@ -34,7 +36,8 @@ private:
   // drawing
 public:
   virtual void draw();
+  Mesh * getMesh( void );
 private:
-  GLuint m_list;										// Display list
+  Mesh *m_mesh;										// the mesh, shared by all objects of the same type
 };
 
@@ -3,9 +3,10 @@
  * \file	MovingObject.cpp
  * \brief	Implements the class for moving objects in 3d game world.
  */
+#include "GlobalGL.h"
 #include "MovingObject.h"
 #include "Vector3.h"
-#include "Vectormath.h"
+#include "VectorMath.h"
 
 /**
  * \brief Constructor, initializes to the origin. The line of vision is aligned to
@@ -18,6 +19,7 @@ MovingObject::MovingObject( ) : GameObject( ) {
   m_maxspeed = 1.0;
   m_minspeed = -0.09f;
   m_step = 1.0f/20.0f;
+  m_hasPrevious = false;
 }
 
 /**
@@ -31,6 +33,7 @@ MovingObject::MovingObject( Vector3 position ) : GameObject( position ) {
   m_maxspeed = 1.0f;
   m_minspeed = -0.09f;
   m_step = 1.0f/20.0f;
+  m_hasPrevious = false;
 }
 
 /**
@@ -46,6 +49,7 @@ MovingObject::MovingObject( float x, float y, float z ) : GameObject( x, y, z )
   m_maxspeed = 1.0f;
   m_minspeed = -0.09f;
   m_step = 1.0f/20.0f;
+  m_hasPrevious = false;
 }
 
 /**
@@ -64,8 +68,11 @@ void MovingObject::pitch( float angle ) {
   Vector3 xa;
 
   xa = view * up;
-  view = VectorMath::rotateVector( angle, xa, view );
-  up = VectorMath::rotateVector( angle, xa, up );
+  // both vectors are rotated by the same angle, sine and cosine are computed once
+  float cosTheta = (float)cos( angle  * M_PI/180.0 );
+  float sinTheta = (float)sin( angle  * M_PI/180.0 );
+  view = VectorMath::rotateVector( cosTheta, sinTheta, xa, view );
+  up = VectorMath::rotateVector( cosTheta, sinTheta, xa, up );
 }
 
 //! Rolls the eye.
@@ -185,3 +192,51 @@ void MovingObject::setSpeed( float speed ) {
 void MovingObject::setStep( float step ) { 
   m_step = step; 
 }
+
+//! Stores the position and the orientation before a simulation step.
+/**
+ * The stored state is used by interpolate() to draw the object between the last two
+ * steps.
+ */
+void MovingObject::keepState( void ) {
+  m_previousPos = getPos();
+  m_previousView = view;
+  m_previousUp = up;
+  m_hasPrevious = true;
+}
+
+//! Moves the object to a state between the kept state and the current state.
+/**
+ * The current state is stored and has to be set again with restoreState() after the
+ * object is drawn. The position is interpolated linearly, the view and up vectors
+ * are interpolated and normalized again. An object that was created after the last
+ * call of keepState() stays at its current state.
+ * \param alpha 0 for the kept state, 1 for the current state
+ */
+void MovingObject::interpolate( float alpha ) {
+  m_simulatedPos = getPos();
+  m_simulatedView = view;
+  m_simulatedUp = up;
+  if( !m_hasPrevious )
+    return;
+
+  setPos( m_previousPos + (m_simulatedPos - m_previousPos) * alpha );
+  Vector3 v = m_previousView + (m_simulatedView - m_previousView) * alpha;
+  Vector3 u = m_previousUp + (m_simulatedUp - m_previousUp) * alpha;
+  if( v.length() < 0.001f || u.length() < 0.001f ) // the object has turned around in one step
+    return;
+  v.normalize();
+  u = u - v * u.innerProduct( v ); // keep up orthogonal to the view
+  u.normalize();
+  view = v;
+  up = u;
+}
+
+/**
+ * \brief Sets the state that was current before interpolate() was called.
+ */
+void MovingObject::restoreState( void ) {
+  setPos( m_simulatedPos );
+  view = m_simulatedView;
+  up = m_simulatedUp;
+}
@@ -49,4 +49,18 @@ private:
   float m_maxspeed;// maximal speed
   float m_speed; // speed
   float m_step;// step of accelerations
+
+  // drawing between two simulation steps
+public:
+  void keepState( void );
+  void interpolate( float alpha );
+  void restoreState( void );
+private:
+  bool m_hasPrevious; // true, if a state was kept
+  Vector3 m_previousPos;
+  Vector3 m_previousView;
+  Vector3 m_previousUp;
+  Vector3 m_simulatedPos;
+  Vector3 m_simulatedView;
+  Vector3 m_simulatedUp;
 };
@@ -8,7 +8,8 @@
 #include "LittleHelper.h"
 #include "World.h"
 #include "ObjectLoader3ds.h"
-#include "VectorMath.h"
+#include "Mesh.h"
+#include "MappedFile.h"
 
 using namespace std;
 
@@ -66,42 +67,87 @@ void Objects::loadObject( unsigned int object, string filename, float factor ) {
 
   // load new object. currently, only 3ds is usable. all files are identified by their ending
   // the loader should test if the file contains data in the right type
-  if( LittleHelper::stringCmpi( filename.substr(filename.length() - 3, 3), "3ds" ) == 0) {
-    loadObject3DS( object, filename, factor );
-  }
+  Mesh *mesh = decodeObject( filename, factor );
+  if( mesh != 0 )
+    loadObject( object, filename, mesh );
 }
 
+//! Puts a mesh that has already been created into the object list.
 /**
- * \brief Loads a 3d studio object from a given filename.
- * 
- * The model is loaded using the ObjectLoader3ds class and
- * the information is used to create the diplay list. After
- * loading the model the structure which should hold the object
- * propertys is initialized, therefore the view has to be submitted.
- * \param object the object that is to be loaded
- * \param filename the file which contains the mesh data
+ * The mesh is uploaded to the graphics card and the structure which holds the
+ * object properties is initialized. The objects take the ownership of the mesh.
+ * \param object number of the object
+ * \param filename filename of the object file the mesh was created from
+ * \param mesh the mesh, see decodeObject()
  */
-void Objects::loadObject3DS( unsigned int object, string filename, float factor ) {
-  ObjectInfo oi;
-  ObjectLoader3ds *model;
+void Objects::loadObject( unsigned int object, string filename, Mesh *mesh ) {
+  if( object >= objectList.size() )
+    reserve( object + 1 );
+  if( objectList[object].object != -1 )
+    freeObject( object );
 
+  ObjectInfo oi;
   oi.filename = filename;
   oi.object = object;
-  model = new ObjectLoader3ds();
-  model->LoadModel( filename.c_str() );
-  oi.displayList = createDisplayList( model, factor );
-  delete model;
+  oi.mesh = mesh;
+  oi.mesh->upload();
   oi.view = Vector3( 0, 0, 1 );
   objectList[object] = oi;
 }
 
+//! Creates the mesh for an object file.
+/**
+ * The file type is identified by the ending, currently only 3ds is usable. No
+ * OpenGL functions are called, so this can be done in any thread.
+ * \param filename filename of the object file
+ * \param factor the factor by which the loaded object is stretched
+ * \return the mesh, or 0 if the file type is not supported. The caller has to
+ * delete the mesh or pass it to loadObject().
+ */
+Mesh * Objects::decodeObject( const string &filename, float factor ) {
+  if( LittleHelper::stringCmpi( filename.substr(filename.length() - 3, 3), "3ds" ) == 0)
+    return decodeObject3DS( filename, factor );
+  return 0;
+}
+
+/**
+ * \brief Creates the mesh for a 3d studio object from a given filename.
+ * 
+ * The mesh is taken from the cache file next to the model, if the cache was created from the
+ * same file content and scale factor. Otherwise the model is loaded using the ObjectLoader3ds
+ * class, the information is used to create the mesh and the cache is written.
+ * \param filename the file which contains the mesh data
+ * \param factor the factor by which the loaded object is stretched
+ * \return the mesh
+ */
+Mesh * Objects::decodeObject3DS( const string &filename, float factor ) {
+  // the cache is identified by the content of the model file and the scale factor
+  string cacheFile = filename.substr( 0, filename.length() - 3 ) + "mesh";
+  unsigned int key = 0;
+  MappedFile source;
+  if( source.open( filename ) ) {
+    key = MappedFile::hash( source.getData(), source.getSize() );
+    key = MappedFile::hash( (const unsigned char *)&factor, sizeof( factor ), key );
+    source.close();
+  }
+  Mesh *mesh = Mesh::loadCache( cacheFile, key );
+  if( mesh == 0 ) {
+    ObjectLoader3ds *model = new ObjectLoader3ds();
+    model->LoadModel( filename.c_str() );
+    mesh = new Mesh( model, factor );
+    mesh->saveCache( cacheFile, key );
+    delete model;
+  }
+  return mesh;
+}
+
 /**
  * \brief Frees one object.
  *
  * Reset the object to the initial values, that means the object is set to an
  * object named '1-'. This value should be used to test if the object exists 
- * the display list can't be set to an invalid value and it's not easy to
- * check if the view is invalid. Same for the string.
+ * because it's not easy to check if the view is invalid. Same for the string.
+ * The mesh is deleted and the pointer is reset to 0.
  * \param object the object that is to be deleted
  */
 void Objects::freeObject( unsigned int object ) {
@@ -110,10 +156,10 @@ void Objects::freeObject( unsigned int object ) {
   if( objectList[object].object == -1 ) // try to free object which is assigned to no object
     return;
 
-  glDeleteLists( objectList[object].displayList, 1 );
+  delete objectList[object].mesh;
 
   objectList[object].object = -1;
-  objectList[object].displayList = 0;
+  objectList[object].mesh = 0;
   objectList[object].view = Vector3( 0, 0, 1 );
   objectList[object].filename = "";
 }
@@ -144,14 +190,14 @@ void Objects::reserve( unsigned int objectCount ) {
 }
 
 /**
- * \brief Returns the display list that was created for an object.
+ * \brief Returns the mesh that was created for an object.
  * \param object the object
  */
-GLuint Objects::getDisplayList ( unsigned int object ) {
-  if( (unsigned)object > objectList.size() )
+Mesh * Objects::getMesh ( unsigned int object ) {
+  if( (unsigned)object >= objectList.size() )
     return 0;
 
-  return objectList[object].displayList;
+  return objectList[object].mesh;
 }
 
 /**
@@ -164,111 +210,3 @@ Vector3 Objects::getObjectView ( unsigned int object ) {
 
   return objectList[object].view;
 }
-
-//! Creates the display list for an object.
-/**
- * Creates a new display list that displays a model. It draws all vertices of
- * a model, calculates the colors and normals and sets texture coordinates.
- * \param model the model, contains mesh data 
- * \param factor a factor that scales the model size
- */
-GLuint Objects::createDisplayList( ObjectLoader3ds * model, float factor ) {
-  GLuint list = glGenLists(1);
-  glNewList( list, GL_COMPILE ); // New Compiled box Display List
-  glPushAttrib( GL_ALL_ATTRIB_BITS );
-  glEnable( GL_COLOR_MATERIAL );
-  glColorMaterial( GL_FRONT, GL_AMBIENT_AND_DIFFUSE );
-  // Loop through all meshes that are apart of the file
-  // and render them.
-  //glBindTexture( GL_TEXTURE_2D, m_texture );// textures are at present disabled!
-  glDisable( GL_TEXTURE_2D );
-  for(int i = 0; i < model->totalMeshes; i++) {
-    glBegin(GL_TRIANGLES);
-
-    // Draw each triangle of this mesh.
-    for(unsigned int f = 0; f < model->meshList[i].totalFaces; f++) {
-      // Get pointers to make the below code cleaner.
-      stMesh *pMesh = &model->meshList[i];
-      stFace *pFace = pMesh->pFaces;
-      stTexCoord *pTexCoord = pMesh->pTexCoords;
-
-      // If one or both or NULL, we got a problem.
-      if(!pMesh || !pFace) continue;
-
-      // Draw the triangle.
-      glNormal3f(pFace[f].normal.x, pFace[f].normal.y,
-        pFace[f].normal.z);
-
-      // set the color
-      int material = pFace[f].matId;
-
-      stMaterial *pMaterial = &model->materialList[material];
-
-      float color[] = {1,0,0,1};
-
-      glColor3f((float) pMaterial->colorDiffuse.r / 255.0, (float) pMaterial->colorDiffuse.g / 255.0, (float) pMaterial->colorDiffuse.b / 255.0);
-      //glMaterialf( GL_FRONT, GLenum pname, TYPE param ) // only for shininess
-
-      //glMaterialf( GL_FRONT, GL_SHININESS, 0.0);
-      //color[0] = (float) pMaterial->colorAmbient.r / 255.0;
-      //color[1] = (float) pMaterial->colorAmbient.g / 255.0;
-      //color[2] = (float) pMaterial->colorAmbient.b / 255.0;
-      //glMaterialfv( GL_FRONT, GL_AMBIENT, color );
-
-      //color[0] = (float) pMaterial->colorDiffuse.r / 255.0;
-      //color[1] = (float) pMaterial->colorDiffuse.g / 255.0;
-      //color[2] = (float) pMaterial->colorDiffuse.b / 255.0;
-      //glMaterialfv( GL_FRONT, GL_DIFFUSE, color );
-
-      //color[0] = (float) pMaterial->colorSpecular.r / 255.0;
-      //color[1] = (float) pMaterial->colorSpecular.g / 255.0;
-      //color[2] = (float) pMaterial->colorSpecular.b / 255.0;
-
-      //color[0] = 1;
-      //color[1] = 0;
-      //color[2] = 1;
-
-      // set speculor to black, it doesn't work correctly with other values -> why?
-      glMaterialfv( GL_FRONT, GL_SPECULAR, color );
-
-
-      // calculate normal
-      Vector3 p1;
-      p1.x = pMesh->pVertices[pFace[f].indices[0]].x*factor;
-      p1.y = pMesh->pVertices[pFace[f].indices[0]].y*factor;
-      p1.z = pMesh->pVertices[pFace[f].indices[0]].z*factor;
-      Vector3 p2;
-      p2.x = pMesh->pVertices[pFace[f].indices[1]].x*factor;
-      p2.y = pMesh->pVertices[pFace[f].indices[1]].y*factor;
-      p2.z = pMesh->pVertices[pFace[f].indices[1]].z*factor;
-      Vector3 p3;
-      p3.x = pMesh->pVertices[pFace[f].indices[2]].x*factor;
-      p3.y = pMesh->pVertices[pFace[f].indices[2]].y*factor;
-      p3.z = pMesh->pVertices[pFace[f].indices[2]].z*factor;
-
-      Vector3 normale = VectorMath::normal(p1, p2, p3);
-
-      glNormal3f(normale.x, normale.y, normale.z);
-
-      if(pTexCoord) glTexCoord2f(pTexCoord[pFace[f].indices[0]].tu, pTexCoord[pFace[f].indices[0]].tv);
-      glVertex3f(pMesh->pVertices[pFace[f].indices[0]].x  * factor,
-        pMesh->pVertices[pFace[f].indices[0]].y *factor,
-        pMesh->pVertices[pFace[f].indices[0]].z *factor);
-
-      if(pTexCoord) glTexCoord2f(pTexCoord[pFace[f].indices[1]].tu, pTexCoord[pFace[f].indices[1]].tv);
-      glVertex3f(pMesh->pVertices[pFace[f].indices[1]].x  * factor,
-        pMesh->pVertices[pFace[f].indices[1]].y  * factor,
-        pMesh->pVertices[pFace[f].indices[1]].z  * factor);
-
-      if(pTexCoord) glTexCoord2f(pTexCoord[pFace[f].indices[2]].tu, pTexCoord[pFace[f].indices[2]].tv);
-      glVertex3f(pMesh->pVertices[pFace[f].indices[2]].x *factor,
-        pMesh->pVertices[pFace[f].indices[2]].y *factor,
-        pMesh->pVertices[pFace[f].indices[2]].z *factor);
-    }
-    glEnd();
-  }
-  glPopAttrib();
-  glEndList();
-  //listCreated = true;
-  return list;
-}
\ No newline at end of file
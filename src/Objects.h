@@ -14,12 +14,13 @@
 
 class ObjectLoader3ds;
 class Vector3;
+class Mesh;
 
 /**
  * \brief Contains a list of loaded 3d objects in the game world and loads more objects.
  *
  * Can load objects from 3d studio files. The objects are loaded and then stored
- * in an OpenGL display list. The class acts as a singleton because each object file
+ * in a Mesh, which is drawn from vertex buffers. The class acts as a singleton because each object file
  * has to be loaded only once, regardless how often the object is used in the actual
  * scene.
  */
@@ -34,16 +35,17 @@ private:
 
   // loading, unloading
 public:
-  void Objects::freeObject( unsigned int object );
-  void Objects::loadObject( unsigned int object, std::string filename, float factor );
+  void freeObject( unsigned int object );
+  void loadObject( unsigned int object, std::string filename, float factor );
+  void loadObject( unsigned int object, std::string filename, Mesh *mesh );
+  static Mesh * decodeObject( const std::string &filename, float factor );
   void reserve( unsigned int count );
 private:
-  void loadObject3DS( unsigned int object, std::string filename, float factor );
-  GLuint createDisplayList( ObjectLoader3ds * model, float factor );
+  static Mesh * decodeObject3DS( const std::string &filename, float factor );
 
   // using objects
 public:
-  GLuint getDisplayList ( unsigned int object );
+  Mesh * getMesh ( unsigned int object );
   Vector3 getObjectView ( unsigned int object );
 
   // internal data structure
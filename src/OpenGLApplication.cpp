@@ -9,6 +9,8 @@
 #include "Textures.h"
 #include "Objects.h"
 #include "FrameCounter.h"
+#include "Profiler.h"
+#include "FrameCapture.h"
 
 /**
  * \fn	int WINAPI WinMain( HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine,
@@ -89,6 +91,7 @@ OpenGLApplication::OpenGLApplication( const char  * className ) {
 
   // initializing the used objects, create new instances
   fc = new FrameCounter();
+  capture = new FrameCapture();
 
   // create global objects
   World::getWorld();
@@ -105,6 +108,7 @@ OpenGLApplication::~OpenGLApplication( void ) {
   delete  Textures::getTextures();
   delete World::getWorld();
   delete fc;
+  delete capture; // waits for the encoder
 }
 
 /**
@@ -141,6 +145,17 @@ FrameCounter * OpenGLApplication::getFrameCounter() {
   return fc;
 }
 
+/**
+ * \fn	FrameCapture * OpenGLApplication::getFrameCapture()
+ *
+ * \brief	Gets the frame capture, that stores the drawn frames as images.
+ * \return	The frame capture.
+ */
+
+FrameCapture * OpenGLApplication::getFrameCapture() {
+  return capture;
+}
+
 /**
  * \fn	unsigned int OpenGLApplication::getFrameLimit( )
  *
@@ -346,6 +361,7 @@ int OpenGLApplication::main( HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR
         }
       }
       deinitialize(); // clean up at the end
+      capture->release(); // the pixel buffers belong to the rendering context
       m_window.kill();
     } else { // creation failed.
       MessageBox(HWND_DESKTOP, "Error creating OpenGL Window", "Error", MB_OK | MB_ICONEXCLAMATION);
@@ -385,8 +401,22 @@ void OpenGLApplication::drawTest() {
     if( fc->getFrameTimeCurrent() < frameTime )
       return;
 
-  update( fc->getFrameTimeCurrent() );
+  {
+    ProfileZone zone( "update" );
+    update( fc->getFrameTimeCurrent() );
+  }
   fc->newFrame();
-  draw();
-  m_window.swap();
+  {
+    ProfileZone zone( "draw" );
+    draw();
+  }
+  if( capture->isCapturing() ) {
+    ProfileZone zone( "capture" );
+    capture->capture( m_window.getWidth(), m_window.getHeight() ); // reads the back buffer
+  }
+  {
+    ProfileZone zone( "swap" ); // waits until the graphics card has finished the frame
+    m_window.swap();
+  }
+  Profiler::getProfiler()->newFrame(); // a profiled frame ends after the swap, so it contains its update and draw
 }
\ No newline at end of file
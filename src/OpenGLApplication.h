@@ -5,6 +5,7 @@
  */
 #include "OpenGLWindow.h"
 class FrameCounter;
+class FrameCapture;
 
 /**
  * \class	OpenGLApplication
@@ -52,6 +53,7 @@ protected:
 
   // get the objects provided by this class
   FrameCounter  * getFrameCounter();
+  FrameCapture  * getFrameCapture();
 
 private:
   // Windows Main-Function and our mainfunction, Window procedure and our messagehandler
@@ -77,4 +79,5 @@ private:
   float frameTime;// time for a frame in milliseconds
   bool useFrameLimit;// soll frame limit benutzt werden?
   FrameCounter *fc; // frame counter, used for accurate timing
+  FrameCapture *capture; // captures the frames before they are shown
 };
@@ -9,7 +9,7 @@
 #define min(a,b)            (((a) < (b)) ? (a) : (b))
 #endif
 
-Pirate::Pirate(float r, GLuint displayList, PlayerObject *player, float maxSpeed):ForeignSpaceShip(r,displayList)
+Pirate::Pirate(float r, Mesh *mesh, PlayerObject *player, float maxSpeed):ForeignSpaceShip(r,mesh)
 {
 	    this->player = player;
 		this->maxSpeed = maxSpeed;
@@ -19,75 +19,66 @@ Pirate::~Pirate(void)
 {
 }
 
-bool Pirate::behindPlayer()
-{
-	Plane plane = Plane(player->getView(), player->getPos());
-	return ( plane.distance( this->getPos()) < 0);
-}
-
 void Pirate::adjust( float t )
 {   
-	Vector3 playerPos = player->getPos();
-	Vector3 myPos = this->getPos();
-
-    Vector3 desiredView = playerPos - myPos;
-	float distance = desiredView.length();
+    Vector3 desiredView = m_playerOffset;
+	float distance = m_playerDistance;
 
 	bool behind = this->behindPlayer();
-	float playerSpeed = player->getSpeed();
+	float playerSpeed = m_player.speed;
 
 	float actualSpeed = this->getSpeed();
 	if (distance < 6)
 	{
 		if (behind) // we are chasing the player
-			this->setSpeed(playerSpeed-0.005); // move slower to get out of range
+			steerSpeed(playerSpeed-0.005); // move slower to get out of range
 			                                  // (or, if playerSpeed negative, move faster backwards)
         if (!behind) // we are in front of the player
-			this->setSpeed(-playerSpeed-0.005); // our speed must be vise versa
+			steerSpeed(-playerSpeed-0.005); // our speed must be vise versa
 
-		this->setShoot(true);
+		steerShoot(true);
 	}
 	if (distance >=6 && distance <= 8)
 	{
 		if (behind)
-			this->setSpeed( playerSpeed );
+			steerSpeed( playerSpeed );
 	    if (!behind)
-			this->setSpeed( -playerSpeed );
-		this->setShoot(true);
+			steerSpeed( -playerSpeed );
+		steerShoot(true);
 	}
 	if (distance > 8 && distance <= 15)
 	{
 		if (behind) // we are chasing the player
-			this->setSpeed(playerSpeed+0.005); // move faster to catch him
+			steerSpeed(playerSpeed+0.005); // move faster to catch him
 			                                  // (or, if playerSpeed negative, move slower backwards)
         if (!behind) // we are in front of the player
-			this->setSpeed(-playerSpeed+0.005); // our speed must be vise versa
-		this->setShoot(true);
+			steerSpeed(-playerSpeed+0.005); // our speed must be vise versa
+		steerShoot(true);
 	}
 	if (distance > 15 && distance <= 250)
 	{
-		this->setSpeed( maxSpeed );
+		steerSpeed( maxSpeed );
 		if (this->shipWasHitOnce())
-			this->setShoot(true);
+			steerShoot(true);
 		else
-			this->setShoot(false);
+			steerShoot(false);
 	}
 
 	if (distance > 250)
 	{
 		if (this->shipWasHitOnce())
 	    {
-	 		this->setShoot(true);
-			this->setSpeed(maxSpeed);
+	 		steerShoot(true);
+			steerSpeed(maxSpeed);
 		}
 		else
 		{
-			this->setSpeed(0);
-			this->setShoot(false);
+			steerSpeed(0);
+			steerShoot(false);
 		}		
 	}
 
 	desiredView.normalize();
-	this->setView(desiredView);
+	steerView(desiredView);
 
 }
\ No newline at end of file
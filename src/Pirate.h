@@ -4,7 +4,7 @@
  * \brief Declaration of a Pirate ship.
  */
 #pragma once
-#include "foreignspaceship.h"
+#include "ForeignSpaceShip.h"
 #include "PlayerObject.h"
 
 //! Pirates have a specific position. If the player comes too near, they start to attack.
@@ -12,7 +12,7 @@ class Pirate :
 	public ForeignSpaceShip
 {
 public:
-	Pirate(float r, GLuint displayList, PlayerObject *player, float maxSpeed);
+	Pirate(float r, Mesh *mesh, PlayerObject *player, float maxSpeed);
 public:
 	~Pirate(void);
 public:
@@ -20,5 +20,4 @@ public:
 private: 
 	PlayerObject *player;
 	float maxSpeed;
-	bool behindPlayer();
 };
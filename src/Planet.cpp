@@ -4,9 +4,12 @@
  * \brief Implementation of a Planet.
  */
 #include "Planet.h"
+#ifndef MELITE_HEADLESS
 #include "Shapes.h"
+#include "SphereMesh.h"
 #include "Textures.h"
 #include "ColorConstants.h"
+#endif
 
 //! Draws a planet with texture and spinning. 
 /**
@@ -24,6 +27,10 @@ GraphicsObject( crashRadius ) {
   m_rotateAngle = 0;
   m_rotateSpeed = 0;
   m_drawRadiusLine = false;
+  m_detail = -1;
+  m_currentAngle = 0;
+  m_positionTime = 0;
+  m_positionState = never;
 }
 
 //! Constructor wich sets the position and radius of the planet. 
@@ -40,7 +47,12 @@ GameObject( x, y, z ),
 GraphicsObject( bothRadiuses ) {
   m_planetRadius = bothRadiuses;
   m_rotateAngle = 0;
+  m_rotateSpeed = 0;
   m_drawRadiusLine = false;
+  m_detail = -1;
+  m_currentAngle = 0;
+  m_positionTime = 0;
+  m_positionState = never;
 }
 
 //! Constructor wich sets the position and radius of the planet. 
@@ -56,6 +68,13 @@ QuadricObject( textureName ),
 GameObject( x, y, z ),
 GraphicsObject( crashRadius ) {
   m_planetRadius = planetRadius;
+  m_rotateAngle = 0;
+  m_rotateSpeed = 0;
+  m_drawRadiusLine = false;
+  m_detail = -1;
+  m_currentAngle = 0;
+  m_positionTime = 0;
+  m_positionState = never;
 }
 
 /**
@@ -68,31 +87,24 @@ Planet::~Planet(void) {
 /**
  * The spinning is done by a
  * SpinningObject, the texture is set through Drawable. The Planet itself is 
- * basically an quadric sphere. In order to run in the xz-area, the planet is
+ * basically a sphere taken from the SphereMesh. In order to run in the xz-area, the planet is
  * rotated about 90 degrees. If the frustum is set to NULL, the planet is
  * always drawn. If frustum is an actual object it is tested if the planet can
  * be culled.
  */
 GLvoid Planet::draw() {
+#ifndef MELITE_HEADLESS
   Textures::getTextures()->bindTexture( getTexture() );
   glColor4f( getColor().x, getColor().y, getColor().z, getColor().a );
 
+  Vector3 pos = getPos();
   glPushMatrix();
-  glRotatef( m_rotateAngle, 0.0, 1.0, 0.0 ); // rotation about a certain angle --> startposition 
-  glRotatef( (glutGet(GLUT_ELAPSED_TIME)*m_rotateSpeed  * 0.001), 0.0, 1.0, 0.0 ); // jahresdrehung
-  //Vector3 pos1 = Vector3( getPos().x, getPos().y, getPos().z );
-  Vector3 pos2 = Vector3( SpinningObject::getPos().x, SpinningObject::getPos().y, SpinningObject::getPos().z );
-  Vector3 pos = pos2;
-  glTranslatef( pos.x, pos.y, pos.z );// translate to supposed position
+  glTranslatef( pos.x, pos.y, pos.z );// translate to the position on the orbit
+  glRotatef( m_currentAngle, 0.0, 1.0, 0.0 ); // keep the orientation the planet had when it was rotated onto the orbit
   this->spin();// spin the planet
   glRotatef( -90, 1.0, 0.0, 0.0 );// rotate because the planet should run xz-space
 
-  // this is not perfect, object is created everytime it's drawn
-  GLUquadricObj *quadObj = gluNewQuadric();
-  gluQuadricDrawStyle( quadObj, GLU_FILL );
-  gluQuadricTexture( quadObj, GL_TRUE );
-  gluSphere( quadObj, m_planetRadius, 32, 32 );
-  gluDeleteQuadric( quadObj );
+  SphereMesh::draw( m_planetRadius, m_detail >= 0 ? m_detail : SphereMesh::getLevel( pos, m_planetRadius ) );
   glPopMatrix();
 
   // try to draw radius line
@@ -103,32 +115,63 @@ GLvoid Planet::draw() {
     Shapes::drawCircleShape(0, 0, 0, 300, radius, colorWhite );
     glPopMatrix();
   }
+#endif
 }
 
 //! Get the current position of the center of the planet.
 /**
+ * The position is cached and computed only once for each call of updatePosition(). If the
+ * cache was invalidated by one of the setters, it is recomputed using the time of the last
+ * update.
  * \return The position after all the rotations have been done. 
  */
 Vector3 Planet::getPos() {
-  GLfloat m[4][4];// define memory space for a single matrix
-  glPushMatrix();
-  glLoadIdentity();
-  glRotatef( m_rotateAngle, 0.0, 1.0, 0.0 ); // rotation about a certain angle --> startposition 
-  glRotatef( (glutGet(GLUT_ELAPSED_TIME)*m_rotateSpeed  * 0.001), 0.0, 1.0, 0.0 ); // jahresdrehung
-  //Vector3 pos1 = Vector3( getPos().x, getPos().y, getPos().z );
-  Vector3 pos2 = Vector3( SpinningObject::getPos().x, SpinningObject::getPos().y, SpinningObject::getPos().z );
-  Vector3 pos = pos2;
-  glTranslatef( pos.x, pos.y, pos.z );// translate to supposed position
-  this->spin();// spin the planet
-  glGetFloatv( GL_MODELVIEW_MATRIX, &m[0][0] );// get the matrix
-  glPopMatrix();
-  // the vector is (0,0,0,1) and therefore we can directly access the needed values!
-  // the components in the 4th column are used as the 4th component of the vector contains the only non-zero-value
-  Vector3 actPos( m[3][0], m[3][1], m[3][2] );
+  if( m_positionState != valid )
+    updatePosition( m_positionTime );
+  return m_currentPos;
+}
 
-  return actPos;
+//! Computes the position of the planet on its orbit for a given time.
+/**
+ * The planet is rotated about the y-axis, first by the start angle and then by the angle
+ * it has moved since the start of the game. The rotation is computed directly, so no
+ * OpenGL context is needed. The spin of the planet is updated to the same time. Should be
+ * called once in each update of the simulation.
+ * \param time the time in milliseconds since the start of the game
+ */
+void Planet::updatePosition( long time ) {
+  m_positionTime = time;
+  m_currentAngle = m_rotateAngle + (float)(time * m_rotateSpeed * 0.001);
+  float angle = m_currentAngle * ANGLE2DEG;
+  float c = cos( angle );
+  float s = sin( angle );
+  Vector3 pos = SpinningObject::getPos();
+  m_currentPos.x = c * pos.x + s * pos.z;
+  m_currentPos.y = pos.y;
+  m_currentPos.z = -s * pos.x + c * pos.z;
+  m_positionState = valid;
+  updatePose( time );
 }
 
+/**
+ * \brief Sets the position of the planet before it is rotated onto its orbit.
+ * \param x the x-position
+ * \param y the y-position
+ * \param z the z-position
+ */
+void Planet::setPos( float x, float y, float z ) {
+  GameObject::setPos( x, y, z );
+  m_positionState = never;
+}
+
+/**
+ * \brief Sets the position of the planet before it is rotated onto its orbit.
+ * \param position the position
+ */
+void Planet::setPos( Vector3 position ) {
+  GameObject::setPos( position );
+  m_positionState = never;
+}
 
 /**
  * \brief Get the current rotate speed.
@@ -145,6 +188,7 @@ float Planet::getRotateSpeed( void ) {
  */
 void Planet::setRotateAngle( float angle ) {
   m_rotateAngle = angle;
+  m_positionState = never;
 }
 
 /**
@@ -153,6 +197,7 @@ void Planet::setRotateAngle( float angle ) {
  */
 void Planet::setRotateSpeed( float speed ) {
   m_rotateSpeed = speed;
+  m_positionState = never;
 }
 
 /**
@@ -161,4 +206,13 @@ void Planet::setRotateSpeed( float speed ) {
  */
 void Planet::setRadiusLineDrawing( bool draw ) {
   m_drawRadiusLine = draw;
-}
\ No newline at end of file
+}
+
+/**
+ * \brief Sets the level of detail of the sphere. If the level is negative, which is the
+ * default, it is chosen by the size of the planet on the screen.
+ * \param level the level of the SphereMesh
+ */
+void Planet::setDetail( int level ) {
+  m_detail = level;
+}
@@ -24,7 +24,11 @@ public:
   void setRotateAngle( float angle );
   void setRotateSpeed( float speed );
   void setRadiusLineDrawing( bool draw );
+  void setDetail( int level );
   Vector3 getPos();
+  void setPos( float x, float y, float z );
+  void setPos( Vector3 position );
+  void updatePosition( long time );
   //void setFrustum( Frustum *frustum );
   //void setCulling( CullingPlanet cullType );
 private:
@@ -32,6 +36,11 @@ private:
   float m_rotateAngle;
   float m_rotateSpeed;
   bool m_drawRadiusLine;
+  int m_detail;// level of detail of the sphere, negative if chosen by the size on the screen
+  Vector3 m_currentPos;// position on the orbit at the time of the last update
+  float m_currentAngle;// rotation about the y-axis at the time of the last update
+  long m_positionTime;// the time used for the last update
+  CullingPlanet m_positionState;// valid if m_currentPos is up to date
   //Frustum * m_frustum;
   //CullingPlanet m_cullType;
 };
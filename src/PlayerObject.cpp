@@ -5,15 +5,15 @@
  */
 #include "PlayerObject.h"
 
-PlayerObject::PlayerObject( float r, GLuint displayList ) : CameraObject( ), SpaceShip( r, displayList ), MovingObject( ) {
+PlayerObject::PlayerObject( float r, Mesh *mesh ) : CameraObject( ), SpaceShip( r, mesh ), MovingObject( ) {
   setShieldRecovering( true );
 }
 
-PlayerObject::PlayerObject( Vector3 position , float r, GLuint displayList ) : CameraObject( position ), SpaceShip( r, displayList ), MovingObject( position ) {
+PlayerObject::PlayerObject( Vector3 position , float r, Mesh *mesh ) : CameraObject( position ), SpaceShip( r, mesh ), MovingObject( position ) {
   setShieldRecovering( true );
 }
 
-PlayerObject::PlayerObject( float x, float y, float z, float r, GLuint displayList ) : CameraObject( x, y, z ), SpaceShip( r, displayList ), MovingObject( x, y, z ), GameObject( x, y, z ) {
+PlayerObject::PlayerObject( float x, float y, float z, float r, Mesh *mesh ) : CameraObject( x, y, z ), SpaceShip( r, mesh ), MovingObject( x, y, z ), GameObject( x, y, z ) {
   setShieldRecovering( true );
 }
 
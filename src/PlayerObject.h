@@ -17,9 +17,9 @@ class PlayerObject :
   public CameraObject, public SpaceShip {
     // constructors
 public:
-  PlayerObject::PlayerObject( float r, GLuint displayList );
-  PlayerObject::PlayerObject( Vector3 position , float r, GLuint displayList );
-  PlayerObject::PlayerObject( float x, float y, float z, float r, GLuint displayList );
+  PlayerObject( float r, Mesh *mesh );
+  PlayerObject( Vector3 position , float r, Mesh *mesh );
+  PlayerObject( float x, float y, float z, float r, Mesh *mesh );
   ~PlayerObject(void);
   void coolLaser( DWORD time );
 };
@@ -5,7 +5,7 @@
  */
 #include "PoliceShip.h"
 
-PoliceShip::PoliceShip(float r, GLuint displayList, std::vector<Vector3> point, PlayerObject* player, float maxSpeed):ForeignSpaceShip(r,displayList)
+PoliceShip::PoliceShip(float r, Mesh *mesh, std::vector<Vector3> point, PlayerObject* player, float maxSpeed):ForeignSpaceShip(r,mesh)
 {
 	this->point = point;
 	aim = 0;
@@ -25,77 +25,69 @@ void PoliceShip::stationWasHit(){
 	m_station_was_hit = true;
 }
 
-bool PoliceShip::behindPlayer()
-{
-	Plane plane = Plane(player->getView(), player->getPos());
-	return ( plane.distance( this->getPos()) < 0);
-}
 void PoliceShip::adjust (float t)
 {
 	if (m_station_was_hit || this->shipWasHitOnce())
 	{ // player has shot the ship -> behave like a pirate and chase player
-		Vector3 playerPos = player->getPos();
-		Vector3 myPos = this->getPos();
-
-		Vector3 desiredView = playerPos - myPos;
-		float distance = desiredView.length();
+		Vector3 desiredView = m_playerOffset;
+		float distance = m_playerDistance;
 
 		bool behind = this->behindPlayer();
-		float playerSpeed = player->getSpeed();
+		float playerSpeed = m_player.speed;
 
 		float actualSpeed = this->getSpeed();
 		if (distance < 6)
 		{
 			if (behind) // we are chasing the player
-				this->setSpeed(playerSpeed-0.005); // move slower to get out of range
+				steerSpeed(playerSpeed-0.005); // move slower to get out of range
 			// (or, if playerSpeed negative, move faster backwards)
 			if (!behind) // we are in front of the player
-				this->setSpeed(-playerSpeed-0.005); // our speed must be vise versa
+				steerSpeed(-playerSpeed-0.005); // our speed must be vise versa
 
-			this->setShoot(true);
+			steerShoot(true);
 		}
 		if (distance >=6 && distance <= 8)
 		{
 			if (behind)
-				this->setSpeed( playerSpeed );
+				steerSpeed( playerSpeed );
 			if (!behind)
-				this->setSpeed( -playerSpeed );
-			this->setShoot(true);
+				steerSpeed( -playerSpeed );
+			steerShoot(true);
 		}
 		if (distance > 8 && distance <= 15)
 		{
 			if (behind) // we are chasing the player
-				this->setSpeed(playerSpeed+0.005); // move faster to catch him
+				steerSpeed(playerSpeed+0.005); // move faster to catch him
 			// (or, if playerSpeed negative, move slower backwards)
 			if (!behind) // we are in front of the player
-				this->setSpeed(-playerSpeed+0.005); // our speed must be vise versa
-			this->setShoot(true);
+				steerSpeed(-playerSpeed+0.005); // our speed must be vise versa
+			steerShoot(true);
 		}
 		if (distance > 15 && distance <= 250)
 		{
-			this->setSpeed( maxSpeed );
+			steerSpeed( maxSpeed );
 			if (m_station_was_hit || this->shipWasHitOnce())
-				this->setShoot(true);
+				steerShoot(true);
 			else
-				this->setShoot(false);
+				steerShoot(false);
 		}
 
 		if (distance > 250)
 		{
 			if (m_station_was_hit || this->shipWasHitOnce())
 			{
-				this->setShoot(true);
-				this->setSpeed(maxSpeed);
+				steerShoot(true);
+				steerSpeed(maxSpeed);
 			}
 			else
 			{
-				this->setSpeed(0);
-				this->setShoot(false);
+				steerSpeed(0);
+				steerShoot(false);
 			}		
 		}
 
 		desiredView.normalize();
-		this->setView(desiredView);	}
+		steerView(desiredView);	}
 	else
 	{ // guarding something (probably the coriolis station)
 		Vector3 directionToAim = point[aim] - this->getPos();
@@ -107,7 +99,7 @@ void PoliceShip::adjust (float t)
 			directionToAim = point[aim] - this->getPos();
 		}
 		directionToAim.normalize();
-		this->setView(directionToAim);
+		steerView(directionToAim);
 	}
 
 }
\ No newline at end of file
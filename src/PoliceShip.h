@@ -4,7 +4,7 @@
  * \brief Definition of the PoliceShip class representing a police ship
  */
 #pragma once
-#include "foreignspaceship.h"
+#include "ForeignSpaceShip.h"
 #include "PlayerObject.h"
 
 //! A police ship.
@@ -17,7 +17,7 @@ class PoliceShip :
 	public ForeignSpaceShip
 {
 public:
-	PoliceShip(float r, GLuint displayList, std::vector<Vector3> point, PlayerObject * player, float maxSpeed);
+	PoliceShip(float r, Mesh *mesh, std::vector<Vector3> point, PlayerObject * player, float maxSpeed);
 public:
 	~PoliceShip(void);
 public:
@@ -28,6 +28,5 @@ private:
 	unsigned int aim;
 	float maxSpeed;
 	PlayerObject * player;
-	bool behindPlayer();
 	bool m_station_was_hit;
 };
@@ -0,0 +1,206 @@
+/**
+ * Copyright Jan-Philipp Kappmeier, Melanie Schmidt
+ * \file	Profiler.cpp
+ * \brief	Implementation of the frame profiler.
+ */
+#include "Profiler.h"
+#include <algorithm>
+#include <string.h>
+#ifdef MELITE_HEADLESS
+#include <chrono>
+#endif
+
+using namespace std;
+
+// the number of frames kept in the ring buffer, some seconds at usual frame rates
+static const unsigned int frameCount = 300;
+// zones are not measured anymore if a frame contains more, e. g. if no frames are ended
+static const unsigned int maxEvents = 1024;
+
+Profiler *Profiler::m_profiler = 0;
+
+//! Public access to singleton object.
+/**
+ * If called for the first time a new instance is created, otherwise the existing
+ * instance is returned.
+ * \return A pointer to the instance of the class
+ */
+Profiler * Profiler::getProfiler( void ) {
+  if( m_profiler == 0 )
+    m_profiler = new Profiler();
+  return m_profiler;
+}
+
+/**
+ * \brief Creates the ring buffer and starts the first frame.
+ */
+Profiler::Profiler( void ) {
+#ifndef MELITE_HEADLESS
+  QueryPerformanceFrequency( &frequency );
+#endif
+  frames.resize( frameCount );
+  for( unsigned int i = 0; i < frameCount; i++ )
+    frames[i].events.reserve( 64 );
+  current = 0;
+  completed = 0;
+  frames[current].start = getMicroseconds();
+  frames[current].duration = 0;
+}
+
+Profiler::~Profiler( void ) {
+}
+
+//! Ends the current frame and starts the next one.
+/**
+ * Zones that are still open are closed at the end of the frame. If the ring buffer is
+ * full, the oldest frame is overwritten.
+ */
+void Profiler::newFrame( void ) {
+  long long now = getMicroseconds();
+  Frame &frame = frames[current];
+  frame.duration = now - frame.start;
+  for( unsigned int i = 0; i < open.size(); i++ )
+    if( open[i] < maxEvents ) // zones that did not fit into the frame are not measured
+      frame.events[open[i]].duration = now - frame.events[open[i]].start;
+  open.clear();
+
+  current = (current + 1) % frameCount;
+  completed = min( completed + 1, frameCount - 1 ); // the current frame is not completed
+  frames[current].start = now;
+  frames[current].duration = 0;
+  frames[current].events.clear();
+}
+
+/**
+ * \brief Starts a zone in the current frame, nested into the zones that are open.
+ * \param name the name of the zone, has to be a string literal
+ */
+void Profiler::beginZone( const char *name ) {
+  Frame &frame = frames[current];
+  if( frame.events.size() >= maxEvents ) {
+    open.push_back( maxEvents ); // marks the zone as not measured
+    return;
+  }
+  Event e;
+  e.name = name;
+  e.depth = (unsigned int)open.size();
+  e.start = getMicroseconds();
+  e.duration = -1;
+  open.push_back( (unsigned int)frame.events.size() );
+  frame.events.push_back( e );
+}
+
+/**
+ * \brief Ends the zone that was started last.
+ */
+void Profiler::endZone( void ) {
+  if( open.empty() )
+    return;
+  unsigned int index = open.back();
+  open.pop_back();
+  if( index < maxEvents ) {
+    Event &e = frames[current].events[index];
+    e.duration = getMicroseconds() - e.start;
+  }
+}
+
+/**
+ * \brief Returns the number of finished frames that are stored.
+ */
+unsigned int Profiler::getFrameCount( void ) {
+  return completed;
+}
+
+//! Returns a percentile of the frame times of the stored frames.
+/**
+ * \param percentile the percentile between 0 and 100, e. g. 50 for the median
+ * \return the frame time in milliseconds, or 0 if no frame was finished
+ */
+float Profiler::getFrameTimePercentile( float percentile ) {
+  if( completed == 0 )
+    return 0;
+  vector<long long> durations( completed );
+  for( unsigned int i = 0; i < completed; i++ )
+    durations[i] = frames[(current + frameCount - 1 - i) % frameCount].duration;
+  unsigned int k = min( completed - 1, (unsigned int)(percentile * 0.01f * completed) );
+  nth_element( durations.begin(), durations.begin() + k, durations.end() );
+  return durations[k] * 0.001f;
+}
+
+//! Computes the average time per frame of each zone over the stored frames.
+/**
+ * Zones with the same name and depth are combined, including zones that occur several
+ * times in a frame. The zones are ordered by their first occurrence, so nested zones
+ * follow the zone they are nested in.
+ * \param times the zone times are stored here, the old content is removed
+ */
+void Profiler::getZoneTimes( vector<ZoneTime> &times ) {
+  times.clear();
+  if( completed == 0 )
+    return;
+  for( unsigned int i = completed; i > 0; i-- ) {
+    const Frame &frame = frames[(current + frameCount - i) % frameCount];
+    for( unsigned int j = 0; j < frame.events.size(); j++ ) {
+      const Event &e = frame.events[j];
+      unsigned int k = 0;
+      while( k < times.size() && (times[k].depth != e.depth || (times[k].name != e.name && strcmp( times[k].name, e.name ) != 0)) )
+        k++;
+      if( k == times.size() ) {
+        ZoneTime t = { e.name, e.depth, 0 };
+        times.push_back( t );
+      }
+      times[k].milliseconds += e.duration * 0.001f;
+    }
+  }
+  for( unsigned int k = 0; k < times.size(); k++ )
+    times[k].milliseconds /= completed;
+}
+
+//! Writes the stored frames into a trace file for the chrome trace viewer.
+/**
+ * Each frame and each zone is written as a complete event. The times are given in
+ * microseconds since the start of the oldest stored frame.
+ * \param filename the file, is overwritten
+ * \return true if the file was written
+ */
+bool Profiler::exportTrace( const string &filename ) {
+  FILE *file = 0;
+#ifndef MELITE_HEADLESS
+  fopen_s( &file, filename.c_str(), "w" );
+#else
+  file = fopen( filename.c_str(), "w" );
+#endif
+  if( !file )
+    return false;
+  fprintf( file, "{\"traceEvents\":[\n" );
+  long long origin = frames[(current + frameCount - completed) % frameCount].start;
+  bool first = true;
+  for( unsigned int i = completed; i > 0; i-- ) {
+    const Frame &frame = frames[(current + frameCount - i) % frameCount];
+    fprintf( file, "%s{\"name\":\"frame\",\"ph\":\"X\",\"pid\":0,\"tid\":0,\"ts\":%lld,\"dur\":%lld}",
+             first ? "" : ",\n", frame.start - origin, frame.duration );
+    first = false;
+    for( unsigned int j = 0; j < frame.events.size(); j++ ) {
+      const Event &e = frame.events[j];
+      fprintf( file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":0,\"tid\":0,\"ts\":%lld,\"dur\":%lld}",
+               e.name, e.start - origin, e.duration );
+    }
+  }
+  fprintf( file, "\n],\"displayTimeUnit\":\"ms\"}\n" );
+  bool written = ferror( file ) == 0;
+  fclose( file );
+  return written;
+}
+
+/**
+ * \brief Returns the value of the high resolution clock in microseconds.
+ */
+long long Profiler::getMicroseconds( void ) {
+#ifndef MELITE_HEADLESS
+  LARGE_INTEGER now;
+  QueryPerformanceCounter( &now );
+  return now.QuadPart / frequency.QuadPart * 1000000 + now.QuadPart % frequency.QuadPart * 1000000 / frequency.QuadPart;
+#else
+  return chrono::duration_cast<chrono::microseconds>( chrono::steady_clock::now().time_since_epoch() ).count();
+#endif
+}
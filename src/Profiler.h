@@ -0,0 +1,84 @@
+/**
+ * Copyright Jan-Philipp Kappmeier, Melanie Schmidt
+ * \file	Profiler.h
+ * \brief	Declares a profiler that measures the time spent in nested zones of each frame.
+ */
+#pragma once
+
+#include "GlobalGL.h"
+#include <string>
+#include <vector>
+
+//! The average time spent in a zone per frame.
+struct ZoneTime {
+  const char *name;
+  unsigned int depth;   // the number of zones the zone is nested in
+  float milliseconds;
+};
+
+//! Measures where the time of the frames goes.
+/**
+ * A zone is a part of the code, e. g. the update of the world or the drawing of
+ * the ships, and is measured by a ProfileZone that lives while the code runs. Zones
+ * may be nested. The start and the duration of each zone are taken with a high
+ * resolution clock and stored for the current frame. The last frames are kept in a
+ * ring buffer, which can be evaluated for the distribution of the frame times and the
+ * time per zone, or exported as a trace in the format of the chrome trace viewer
+ * (chrome://tracing).
+ *
+ * A frame is ended by newFrame(), which is called after the buffers are swapped, so a
+ * frame contains its update and its draw. The headless build ends a frame after each
+ * step. The names of the zones are not copied, so they have to be string literals.
+ */
+class Profiler {
+public:
+  static Profiler * getProfiler( void );
+
+  void newFrame( void );
+  void beginZone( const char *name );
+  void endZone( void );
+
+  unsigned int getFrameCount( void );
+  float getFrameTimePercentile( float percentile );
+  void getZoneTimes( std::vector<ZoneTime> &times );
+  bool exportTrace( const std::string &filename );
+private:
+  Profiler( void );
+  ~Profiler( void );
+  long long getMicroseconds( void );
+  static Profiler *m_profiler;
+
+  //! A measured zone.
+  struct Event {
+    const char *name;
+    unsigned int depth;
+    long long start;      // microseconds
+    long long duration;   // microseconds, -1 if the zone is still open
+  };
+  //! A frame with all zones measured in it.
+  struct Frame {
+    long long start;
+    long long duration;
+    std::vector<Event> events;
+  };
+  std::vector<Frame> frames;          // the ring buffer of frames
+  unsigned int current;               // the frame that is measured
+  unsigned int completed;             // the number of finished frames in the ring buffer
+  std::vector<unsigned int> open;     // the events of the open zones, innermost last
+#ifndef MELITE_HEADLESS
+  LARGE_INTEGER frequency;
+#endif
+};
+
+//! Measures a zone from its construction until it is destroyed.
+/**
+ * Declare a local variable at the beginning of a block to measure it:
+ * \code
+ * ProfileZone zone( "update" );
+ * \endcode
+ */
+class ProfileZone {
+public:
+  ProfileZone( const char *name ) { Profiler::getProfiler()->beginZone( name ); }
+  ~ProfileZone( void ) { Profiler::getProfiler()->endZone(); }
+};
@@ -6,6 +6,9 @@
 #include "GlobalGL.h"
 #include "Shapes.h"
 
+std::map<GLint, std::vector<GLfloat> > Shapes::unitCircles;
+std::map<Shapes::ListKey, GLuint> Shapes::lists;
+
 Shapes::Shapes(void) {
 }
 
@@ -18,15 +21,15 @@ void Shapes::drawCircle( Vector3 pos, GLint n, GLfloat r, const GLfloat *colorCe
 
 void Shapes::drawCircle( GLfloat xPos, GLfloat yPos, GLfloat zPos, GLint n, GLfloat r, const GLfloat *colorCenter, const GLfloat *colorSurface ) {
   int i;
-  float alphaPi = ( ( 360.0/n ) / 180.0)  * M_PI;
   if(n <3 )
     printf("\nFehler! Mindestens 3 Ecken!.\n\n");
+  const GLfloat *circle = getUnitCircle( n );
   glBegin( GL_TRIANGLE_FAN );
   glColor3fv(colorCenter);
   glVertex3f( xPos + r/3, yPos + r/3, 0 );
   glColor3fv(colorSurface);
   for(i=0; i <= n; i++)
-    glVertex3f(xPos + cos(i  * alphaPi + M_PI_2)*r, yPos + sin(i  * alphaPi + M_PI_2)*r, zPos);
+    glVertex3f(xPos + circle[2*i]*r, yPos + circle[2*i+1]*r, zPos);
   glEnd();
 }
 
@@ -35,26 +38,34 @@ void Shapes::drawCircleTex( Vector3 pos, GLint n, GLfloat r ) {
 }
 
 void Shapes::drawCircleTex( GLfloat xPos, GLfloat yPos, GLfloat zPos, GLint n, GLfloat r ) {
-  int i;
-  float alphaPi = ( ( 360.0/n ) / 180.0)  * M_PI;
   if(n <3 )
     printf("\nFehler! Mindestens 3 Ecken!.\n\n");
-  glBegin( GL_TRIANGLE_FAN );
-  glTexCoord2f( 0.5, 0.5 );
-  glVertex3f( xPos, yPos, 0 );
-  for(i=0; i <= n; i++) {
-    // texcoords generated as distances +- 0.5 from center
-    glTexCoord2f( 0.5 + cos(i  * alphaPi + M_PI_2)  * 0.5, 0.5 + sin(i  * alphaPi + M_PI_2)  * 0.5 );
-    glVertex3f( xPos + cos(i  * alphaPi + M_PI_2)*r, yPos + sin(i  * alphaPi + M_PI_2)*r, zPos );
+  ListKey key = { true, n, 0, 0 };
+  std::map<ListKey, GLuint>::iterator it = lists.find( key );
+  if( it == lists.end() ) {
+    const GLfloat *circle = getUnitCircle( n );
+    GLuint list = glGenLists( 1 );
+    glNewList( list, GL_COMPILE );
+    glBegin( GL_TRIANGLE_FAN );
+    glTexCoord2f( 0.5, 0.5 );
+    glVertex3f( 0, 0, 0 );
+    for( int i=0; i <= n; i++) {
+      // texcoords generated as distances +- 0.5 from center
+      glTexCoord2f( 0.5 + circle[2*i]  * 0.5, 0.5 + circle[2*i+1]  * 0.5 );
+      glVertex3f( circle[2*i], circle[2*i+1], 0 );
+    }
+    glEnd();
+    glEndList();
+    it = lists.insert( std::make_pair( key, list ) ).first;
   }
-  glEnd();
+  drawList( it->second, xPos, yPos, zPos, r );
 }
 
 void Shapes::drawCircleTex( GLfloat xPos, GLfloat yPos, GLfloat zPos, GLint n, GLfloat r, const GLfloat *colorCenter, const GLfloat *colorSurface ) {
   int i;
-  float alphaPi = ( ( 360.0/n ) / 180.0)  * M_PI;
   if(n <3 )
     printf("\nFehler! Mindestens 3 Ecken!.\n\n");
+  const GLfloat *circle = getUnitCircle( n );
   glBegin( GL_TRIANGLE_FAN );
   glColor3fv( colorCenter );
   glTexCoord2f( 0.5, 0.5 );
@@ -62,59 +73,57 @@ void Shapes::drawCircleTex( GLfloat xPos, GLfloat yPos, GLfloat zPos, GLint n, G
   glColor3fv( colorSurface );
   for(i=0; i <= n; i++) {
     // texcoords generated as distances +- 0.5 from center
-    glTexCoord2f(0.5 + cos( i  * alphaPi + M_PI_2 )  * 0.5, 0.5 + sin( i  * alphaPi + M_PI_2 )  * 0.5 );
-    glVertex3f( xPos + cos(i  * alphaPi + M_PI_2)*r, yPos + sin(i  * alphaPi + M_PI_2)*r, zPos );
+    glTexCoord2f(0.5 + circle[2*i]  * 0.5, 0.5 + circle[2*i+1]  * 0.5 );
+    glVertex3f( xPos + circle[2*i]*r, yPos + circle[2*i+1]*r, zPos );
   }
   glEnd();
 }
 
 void Shapes::drawCircle( GLfloat xPos, GLfloat yPos, GLfloat zPos, GLint n, GLfloat r, float segmentStart, float segmentEnd, const GLfloat *colorCenter, const GLfloat *colorSurface ) {
-  int i;
-  float alphaPi = ( 360.0/n )  * ANGLE2DEG;
-  if(n <3 )
-    printf("\nFehler! Mindestens 3 Ecken!.\n\n");
-  glBegin( GL_TRIANGLE_FAN );
-  glColor3fv(colorCenter);
-  glVertex3f( xPos + r/3, yPos + r/3, 0 );
-  glColor3fv(colorSurface);
-  for(i=0; i <= n; i++)
-    glVertex3f(xPos + cos(i  * alphaPi + M_PI_2)*r, yPos + sin(i  * alphaPi + M_PI_2)*r, zPos);
-  glEnd();
+  // the segment is not used, the whole circle is drawn
+  drawCircle( xPos, yPos, zPos, n, r, colorCenter, colorSurface );
 }
 
 void Shapes::drawCircleShape( GLfloat xPos, GLfloat yPos, GLfloat zPos, GLint n, GLfloat r, const GLfloat * color ) {
   int i;
-  float alphaPi = ( 360.0/n )  * ANGLE2DEG;
-
   if(n < 3)
     printf("\nFehler! Mindestens 3 Ecken!.\n\n");
+  const GLfloat *circle = getUnitCircle( n );
   glLineWidth( 2 );
   glColor3fv( color );
   glBegin( GL_LINE_LOOP );
   for(i=0; i <= n; i++)
-    glVertex3f(xPos + cos(i  * alphaPi + M_PI_2)*r, yPos + sin(i  * alphaPi + M_PI_2)*r, zPos);
+    glVertex3f(xPos + circle[2*i]*r, yPos + circle[2*i+1]*r, zPos);
   glEnd();
 }
 
 void Shapes::drawCircleShape( GLfloat xPos, GLfloat yPos, GLfloat zPos, GLint n, GLfloat r, float segmentStart, float segmentEnd, const GLfloat * color ) {
-  int i;
-  float segmentStart2 = segmentStart - floor(segmentStart/360.0f)*360.0; 
-  float segmentEnd2 = segmentEnd - floor(segmentEnd/360.0f)*360.0; 
-  float alphaPi;
-  if( segmentEnd2 < segmentStart2 )
-    alphaPi = ((360.0 - segmentStart2 + segmentEnd2 )/n)  * ANGLE2DEG;
-  else
-    alphaPi = ((segmentEnd2 - segmentStart2)/n)  * ANGLE2DEG;
-  //float alphaPi = ( 360.0/n )  * ANGLE2DEG;
-
   if(n < 3)
     printf("\nFehler! Mindestens 3 Ecken!.\n\n");
   glLineWidth( 2 );
   glColor3fv( color );
-  glBegin( GL_LINE_STRIP );
-  for(i=0; i <= n; i++)
-    glVertex3f(xPos + cos(i  * alphaPi + M_PI_2 + segmentStart2*ANGLE2DEG)*r, yPos + sin(i  * alphaPi + M_PI_2 + segmentStart2*ANGLE2DEG)*r, zPos);
-  glEnd();
+
+  ListKey key = { false, n, segmentStart, segmentEnd };
+  std::map<ListKey, GLuint>::iterator it = lists.find( key );
+  if( it == lists.end() ) {
+    float segmentStart2 = segmentStart - floor(segmentStart/360.0f)*360.0; 
+    float segmentEnd2 = segmentEnd - floor(segmentEnd/360.0f)*360.0; 
+    float alphaPi;
+    if( segmentEnd2 < segmentStart2 )
+      alphaPi = ((360.0 - segmentStart2 + segmentEnd2 )/n)  * ANGLE2DEG;
+    else
+      alphaPi = ((segmentEnd2 - segmentStart2)/n)  * ANGLE2DEG;
+
+    GLuint list = glGenLists( 1 );
+    glNewList( list, GL_COMPILE );
+    glBegin( GL_LINE_STRIP );
+    for( int i=0; i <= n; i++)
+      glVertex3f(cos(i  * alphaPi + M_PI_2 + segmentStart2*ANGLE2DEG), sin(i  * alphaPi + M_PI_2 + segmentStart2*ANGLE2DEG), 0);
+    glEnd();
+    glEndList();
+    it = lists.insert( std::make_pair( key, list ) ).first;
+  }
+  drawList( it->second, xPos, yPos, zPos, r );
 }
 
 void Shapes::drawCircleShape( Vector3 pos, GLint n, GLfloat r, float segmentStart, float segmentEnd, const GLfloat * color ) {
@@ -124,15 +133,14 @@ void Shapes::drawCircleShape( Vector3 pos, GLint n, GLfloat r, float segmentStar
 
 void Shapes::drawCircleShapeDashed( GLfloat xPos, GLfloat yPos, GLfloat zPos, GLint n, GLfloat r, const GLfloat * color ) {
   int i;
-  float alphaPi = ( 360.0/n )  * ANGLE2DEG;
-
   if(n < 3)
     printf("\nFehler! Mindestens 3 Ecken!.\n\n");
+  const GLfloat *circle = getUnitCircle( n );
   glLineWidth( 2 );
   glColor3fv( color );
   glBegin( GL_LINES );
   for(i=0; i <= n; i+=2)
-    glVertex3f(xPos + cos(i  * alphaPi + M_PI_2)*r, yPos + sin(i  * alphaPi + M_PI_2)*r, zPos);
+    glVertex3f(xPos + circle[2*i]*r, yPos + circle[2*i+1]*r, zPos);
   glEnd();
 }
 
@@ -144,3 +152,57 @@ void Shapes::drawRect( GLfloat xCenterPos, GLfloat yCenterPos, GLfloat zPos, GLf
   glVertex3f( xCenterPos + width*0.5, yCenterPos + height*0.5, zPos );
   glEnd();
 }
+
+/**
+ * \brief Deletes the display lists and the unit circles. Has to be called while the rendering context is current.
+ */
+void Shapes::release( void ) {
+  for( std::map<ListKey, GLuint>::iterator it = lists.begin(); it != lists.end(); ++it )
+    glDeleteLists( it->second, 1 );
+  lists.clear();
+  unitCircles.clear();
+}
+
+//! Returns the points of a unit circle.
+/**
+ * The first point is at the top, the points follow counterclockwise. The table is
+ * computed when a circle with n segments is drawn the first time.
+ * \param n the number of segments
+ * \return n+1 points as x and y coordinates, the last point equals the first
+ */
+const GLfloat * Shapes::getUnitCircle( GLint n ) {
+  std::vector<GLfloat> &circle = unitCircles[n];
+  if( circle.empty() ) {
+    float alphaPi = ( 360.0/n )  * ANGLE2DEG;
+    circle.resize( 2 * (n+1) );
+    for( int i=0; i <= n; i++ ) {
+      circle[2*i] = cos(i  * alphaPi + M_PI_2);
+      circle[2*i+1] = sin(i  * alphaPi + M_PI_2);
+    }
+  }
+  return &circle[0];
+}
+
+/**
+ * \brief Draws a display list of a unit size shape, moved to a position and scaled to a radius.
+ */
+void Shapes::drawList( GLuint list, GLfloat xPos, GLfloat yPos, GLfloat zPos, GLfloat r ) {
+  glPushMatrix();
+  glTranslatef( xPos, yPos, zPos );
+  glScalef( r, r, 1 );
+  glCallList( list );
+  glPopMatrix();
+}
+
+/**
+ * \brief Orders the keys lexicographically.
+ */
+bool Shapes::ListKey::operator<( const ListKey &k ) const {
+  if( textured != k.textured )
+    return textured < k.textured;
+  if( n != k.n )
+    return n < k.n;
+  if( segmentStart != k.segmentStart )
+    return segmentStart < k.segmentStart;
+  return segmentEnd < k.segmentEnd;
+}
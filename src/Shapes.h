@@ -6,7 +6,18 @@
 #pragma once
 
 #include "Vector3.h"
+#include <vector>
+#include <map>
 
+//! Draws circles and rectangles in immediate mode.
+/**
+ * The points of a circle with a given number of segments are taken from a table of
+ * the unit circle, which is computed once for each number of segments. Textured circles
+ * and circle segments, which are used for the radar and the shield of the hud, are
+ * compiled once into display lists at unit size and drawn with a transformation. The
+ * tables and lists have to be freed with release() before the rendering context is
+ * destroyed.
+ */
 class Shapes {
 public:
   static void drawCircle( Vector3 pos, GLint n, GLfloat r, const GLfloat *colorCenter, const GLfloat *colorSurface );
@@ -20,7 +31,21 @@ public:
   static void drawCircleShape( Vector3 pos, GLint n, GLfloat r, float segmentStart, float segmentEnd, const GLfloat * color );
   static void drawCircleShapeDashed( GLfloat xPos, GLfloat yPos, GLfloat zPos, GLint n, GLfloat r, const GLfloat * color );
   static void drawRect( GLfloat xCenterPos, GLfloat yCenterPos, GLfloat zPos, GLfloat width, GLfloat height );
+  static void release( void );
 private:
   Shapes( void );
   ~Shapes( void );
+  static const GLfloat * getUnitCircle( GLint n );
+  static void drawList( GLuint list, GLfloat xPos, GLfloat yPos, GLfloat zPos, GLfloat r );
+
+  //! Identifies a display list by the shape and its segments.
+  struct ListKey {
+    bool textured;
+    GLint n;
+    float segmentStart;
+    float segmentEnd;
+    bool operator<( const ListKey &k ) const;
+  };
+  static std::map<GLint, std::vector<GLfloat> > unitCircles;
+  static std::map<ListKey, GLuint> lists;
 };
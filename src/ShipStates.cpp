@@ -0,0 +1,137 @@
+/**
+ * Copyright Jan-Philipp Kappmeier, Melanie Schmidt
+ * \file	ShipStates.cpp
+ * \brief	Implementation of the batch kernels over the motion state of the ships.
+ */
+#include "ShipStates.h"
+#include <math.h>
+#ifdef SHIPSTATES_SSE
+#include <xmmintrin.h>
+#endif
+
+ShipStates::ShipStates( void ) : m_size( 0 ) {
+}
+
+ShipStates::~ShipStates( void ) {
+}
+
+/**
+ * \brief Removes all ships. The reserved memory is kept for the next update.
+ */
+void ShipStates::clear( void ) {
+  m_size = 0;
+}
+
+//! Adds the state of a ship.
+/**
+ * The ships are identified by the order in which they are added.
+ * \param pos the position of the ship
+ * \param view the direction of view, in which the ship moves
+ * \param speed the speed of the ship
+ */
+void ShipStates::add( const Vector3 &pos, const Vector3 &view, float speed ) {
+  if( m_size == m_posX.size() )
+    grow();
+  m_posX[m_size] = pos.x; m_posY[m_size] = pos.y; m_posZ[m_size] = pos.z;
+  m_viewX[m_size] = view.x; m_viewY[m_size] = view.y; m_viewZ[m_size] = view.z;
+  m_speed[m_size] = speed;
+  m_size++;
+}
+
+/**
+ * \brief Returns the number of ships.
+ */
+unsigned int ShipStates::size( void ) {
+  return m_size;
+}
+
+//! Enlarges all arrays by four entries.
+/**
+ * The arrays always have a length that is a multiple of four, so the kernels can process the ships
+ * in groups of four. The unused entries at the end are computed, but never read.
+ */
+void ShipStates::grow( void ) {
+  unsigned int length = (unsigned int)m_posX.size() + 4;
+  m_posX.resize( length, 0 ); m_posY.resize( length, 0 ); m_posZ.resize( length, 0 );
+  m_viewX.resize( length, 0 ); m_viewY.resize( length, 0 ); m_viewZ.resize( length, 0 );
+  m_speed.resize( length, 0 );
+  m_offsetX.resize( length, 0 ); m_offsetY.resize( length, 0 ); m_offsetZ.resize( length, 0 );
+  m_distance.resize( length, 0 );
+}
+
+//! Computes the vectors from all ships to a target and their lengths.
+/**
+ * The results can be read with getOffset() and getDistance().
+ * \param target the target, e. g. the position of the player
+ */
+void ShipStates::computeOffsets( const Vector3 &target ) {
+  unsigned int i = 0;
+#ifdef SHIPSTATES_SSE
+  __m128 tx = _mm_set1_ps( target.x );
+  __m128 ty = _mm_set1_ps( target.y );
+  __m128 tz = _mm_set1_ps( target.z );
+  for( ; i < m_size; i += 4 ) {
+    __m128 dx = _mm_sub_ps( tx, _mm_loadu_ps( &m_posX[i] ) );
+    __m128 dy = _mm_sub_ps( ty, _mm_loadu_ps( &m_posY[i] ) );
+    __m128 dz = _mm_sub_ps( tz, _mm_loadu_ps( &m_posZ[i] ) );
+    _mm_storeu_ps( &m_offsetX[i], dx );
+    _mm_storeu_ps( &m_offsetY[i], dy );
+    _mm_storeu_ps( &m_offsetZ[i], dz );
+    __m128 sq = _mm_add_ps( _mm_add_ps( _mm_mul_ps( dx, dx ), _mm_mul_ps( dy, dy ) ), _mm_mul_ps( dz, dz ) );
+    _mm_storeu_ps( &m_distance[i], _mm_sqrt_ps( sq ) );
+  }
+#else
+  for( ; i < m_size; i++ ) {
+    m_offsetX[i] = target.x - m_posX[i];
+    m_offsetY[i] = target.y - m_posY[i];
+    m_offsetZ[i] = target.z - m_posZ[i];
+    m_distance[i] = (float)sqrt( m_offsetX[i]*m_offsetX[i] + m_offsetY[i]*m_offsetY[i] + m_offsetZ[i]*m_offsetZ[i] );
+  }
+#endif
+}
+
+//! Moves all ships along their direction of view.
+/**
+ * Each ship covers the distance of its speed in the given time, as in MovingObject::advance().
+ * \param t the time in milliseconds
+ */
+void ShipStates::advance( float t ) {
+  unsigned int i = 0;
+#ifdef SHIPSTATES_SSE
+  __m128 time = _mm_set1_ps( t );
+  for( ; i < m_size; i += 4 ) {
+    __m128 step = _mm_mul_ps( time, _mm_loadu_ps( &m_speed[i] ) );
+    _mm_storeu_ps( &m_posX[i], _mm_add_ps( _mm_loadu_ps( &m_posX[i] ), _mm_mul_ps( step, _mm_loadu_ps( &m_viewX[i] ) ) ) );
+    _mm_storeu_ps( &m_posY[i], _mm_add_ps( _mm_loadu_ps( &m_posY[i] ), _mm_mul_ps( step, _mm_loadu_ps( &m_viewY[i] ) ) ) );
+    _mm_storeu_ps( &m_posZ[i], _mm_add_ps( _mm_loadu_ps( &m_posZ[i] ), _mm_mul_ps( step, _mm_loadu_ps( &m_viewZ[i] ) ) ) );
+  }
+#else
+  for( ; i < m_size; i++ ) {
+    float step = t * m_speed[i];
+    m_posX[i] = m_posX[i] + step * m_viewX[i];
+    m_posY[i] = m_posY[i] + step * m_viewY[i];
+    m_posZ[i] = m_posZ[i] + step * m_viewZ[i];
+  }
+#endif
+}
+
+/**
+ * \brief Returns the position of a ship, e. g. after advance().
+ */
+Vector3 ShipStates::getPos( unsigned int index ) {
+  return Vector3( m_posX[index], m_posY[index], m_posZ[index] );
+}
+
+/**
+ * \brief Returns the vector from a ship to the target of the last computeOffsets().
+ */
+Vector3 ShipStates::getOffset( unsigned int index ) {
+  return Vector3( m_offsetX[index], m_offsetY[index], m_offsetZ[index] );
+}
+
+/**
+ * \brief Returns the distance from a ship to the target of the last computeOffsets().
+ */
+float ShipStates::getDistance( unsigned int index ) {
+  return m_distance[index];
+}
@@ -0,0 +1,50 @@
+/**
+ * Copyright Jan-Philipp Kappmeier, Melanie Schmidt
+ * \file	ShipStates.h
+ * \brief	Declares a structure of arrays holding the motion state of all ships for batch updates.
+ */
+#pragma once
+
+#include "Vector3.h"
+#include <vector>
+
+// the kernels use SSE if the compiler supports it, otherwise a scalar loop is used
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define SHIPSTATES_SSE
+#endif
+
+//! The motion state of a number of ships, stored as structure of arrays.
+/**
+ * Each component of the position, the view and the offset to a target is kept in its own array, so
+ * that the kernels process four ships with one SSE instruction. The arrays are padded to a multiple
+ * of four. The buffer is meant to be refilled in each update: clear it, add all ships, run the
+ * kernels and read the results back. The ships themselves stay the owners of their state.
+ *
+ * The kernels execute the same floating point operations in the same order as the scalar code in
+ * Vector3 and MovingObject, so the results are the same as without the buffer.
+ */
+class ShipStates {
+public:
+  ShipStates( void );
+  ~ShipStates( void );
+
+  void clear( void );
+  void add( const Vector3 &pos, const Vector3 &view, float speed );
+  unsigned int size( void );
+
+  void computeOffsets( const Vector3 &target );
+  void advance( float t );
+
+  Vector3 getPos( unsigned int index );
+  Vector3 getOffset( unsigned int index );
+  float getDistance( unsigned int index );
+private:
+  void grow( void );
+
+  unsigned int m_size;
+  std::vector<float> m_posX, m_posY, m_posZ;
+  std::vector<float> m_viewX, m_viewY, m_viewZ;
+  std::vector<float> m_speed;
+  std::vector<float> m_offsetX, m_offsetY, m_offsetZ;
+  std::vector<float> m_distance;
+};
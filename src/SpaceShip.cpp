@@ -4,43 +4,42 @@
  * \brief Implementation of a space ship.
  */
 #include "SpaceShip.h"
-#include "Plane.h"
 
 //! Initializes the space ship.
 /**
- * The radius and the display list have to be
+ * The radius and the mesh have to be
  * submitted if an object is initialized. The starting position is set to the
  * origin.
  * \param r the radius
- * \param displayList the display list
+ * \param mesh the mesh
  */
-SpaceShip::SpaceShip( float r, GLuint displayList ) : MovingObject( ), ModelObject( r, displayList ) {
+SpaceShip::SpaceShip( float r, Mesh *mesh ) : MovingObject( ), ModelObject( r, mesh ) {
   initialize();
 }
 
 //! Initializes the space ship.
 /**
- * The radius and the display list have to be
+ * The radius and the mesh have to be
  * submitted if an object is initialized.
  * \param position the position as Vector3
  * \param r the radius
- * \param displayList the display list
+ * \param mesh the mesh
  */
-SpaceShip::SpaceShip( Vector3 position, float r, GLuint displayList ) : MovingObject( position ), ModelObject( r, displayList ) {
+SpaceShip::SpaceShip( Vector3 position, float r, Mesh *mesh ) : MovingObject( position ), ModelObject( r, mesh ) {
   initialize();
 }
 
 //! Initializes the space ship.
 /**
- * The radius and the display list have to be
+ * The radius and the mesh have to be
  * submitted if an object is initialized.
  * \param x the x-position
  * \param y the y-position
  * \param z the z-position
  * \param r the radius
- * \param displayList the display list
+ * \param mesh the mesh
  */
-SpaceShip::SpaceShip( float x, float y, float z, float r, GLuint displayList ) : MovingObject( x, y, z ), ModelObject( r, displayList ) {
+SpaceShip::SpaceShip( float x, float y, float z, float r, Mesh *mesh ) : MovingObject( x, y, z ), ModelObject( r, mesh ) {
   initialize();
 }
 
@@ -73,37 +72,45 @@ void SpaceShip::initialize( void ) {
 
 //! Draws the object using the base class drawing method.
 /**
- * Previously it is translated to the current position.
+ * Previously it is translated to the current position and rotated to the view of the ship.
  */
 GLvoid SpaceShip::draw( void ) {
+#ifndef MELITE_HEADLESS
+  GLfloat m[16];
+  getTransformation( m );
   glPushMatrix();
-  glTranslatef( getPos().x, getPos().y, getPos().z );
-
-  Vector3 orgView = this->getOriginalView();
-  orgView.normalize();
-
-  Vector3 actView = this->getView();
-  actView.normalize();
-
-  Vector3 orthogonal = orgView  * actView;
-  orthogonal.normalize();
-
-  float projection = orgView.innerProduct(actView); // / actView.length();
-  float angle = acos(projection) / ANGLE2DEG;
-
-  Vector3 nullvector = Vector3(0,0,0);
-
-  Plane * testplane = new Plane(nullvector, orthogonal, orgView);
-
-  float testdistance = testplane->distance(actView);
-
-  if (testdistance < 0)
-    angle = 360 - angle;
-
-  glRotatef(angle,orthogonal.x,orthogonal.y,orthogonal.z);
-
+  glMultMatrixf( m );
   ModelObject::draw();
   glPopMatrix();
+#endif
+}
+
+//! Computes the matrix that moves the model to the position and orientation of the ship.
+/**
+ * The model looks along the original view with the original up vector, that
+ * is along the z-axis with the y-axis upwards. The columns of the rotation are
+ * the right, up and view vectors of the ship. As the up vector is not updated
+ * if only the view changes, it is made orthogonal to the view first. If both
+ * are nearly parallel, some other vector is used.
+ * \param m the matrix in the column major order used by OpenGL
+ */
+void SpaceShip::getTransformation( GLfloat m[16] ) {
+  Vector3 view = getView();
+  view.normalize();
+  Vector3 up = getUp();
+  up = up - view * up.innerProduct( view );
+  if( up.length() < 0.001f ) {
+    up = fabs( view.x ) < 0.9f ? Vector3( 1, 0, 0 ) : Vector3( 0, 1, 0 );
+    up = up - view * up.innerProduct( view );
+  }
+  up.normalize();
+  Vector3 right = up * view;
+  Vector3 pos = getPos();
+
+  m[0] = right.x; m[4] = up.x; m[8] = view.x;  m[12] = pos.x;
+  m[1] = right.y; m[5] = up.y; m[9] = view.y;  m[13] = pos.y;
+  m[2] = right.z; m[6] = up.z; m[10] = view.z; m[14] = pos.z;
+  m[3] = 0;       m[7] = 0;    m[11] = 0;      m[15] = 1;
 }
 
 //! Determines wheather a ship is destroyed or not.
@@ -152,22 +159,42 @@ void SpaceShip::advance( float time)
  */
 void SpaceShip::updateLaser( float time ) {
 	if ( shooting && !m_overHeated )
-		useLaser(t);
+		useLaser(time);
 	else
-		coolLaser(t);
+		coolLaser(time);
 }
 
 //! Updates the ship's status after a time interval.
 /**
- * Recovers shields, weapons and updates the position.
- * \param time the delta time in milliseconds
+ * Steers the ship, recovers shields, weapons and updates the position.
+ * World::tick() calls steer() and updateSystems() itself and moves all ships
+ * together afterwards.
+ * \param t the delta time in milliseconds
  */
 void SpaceShip::update( float t) {
+  steer(t);
+  updateSystems(t);
+	advance(t);
+}
+
+//! Changes direction and speed of the ship.
+/**
+ * A plain space ship does not steer itself, derived classes implement
+ * their behavior here.
+ * \param t the delta time in milliseconds
+ */
+void SpaceShip::steer( float t ) {
+}
+
+//! Recovers shields and weapons after a time interval.
+/**
+ * \param t the delta time in milliseconds
+ */
+void SpaceShip::updateSystems( float t ) {
   if( m_shieldRecovers ) {
     this->recoverShieldBack( t );
     this->recoverShieldFront( t );
   }
-	advance(t);
 	updateLaser(t);
 }
 
@@ -19,11 +19,11 @@
  */
 class SpaceShip :
   virtual public MovingObject, public ModelObject {
-    // constructor, needs a display list
+    // constructor, needs a mesh
 public:
-  SpaceShip( float r, GLuint displayList );
-  SpaceShip( Vector3 position, float r, GLuint displayList );
-  SpaceShip( float x, float y, float z, float r, GLuint displayList );
+  SpaceShip( float r, Mesh *mesh );
+  SpaceShip( Vector3 position, float r, Mesh *mesh );
+  SpaceShip( float x, float y, float z, float r, Mesh *mesh );
   ~SpaceShip(void);
 private:
   void initialize();
@@ -31,6 +31,7 @@ private:
   // draw the ship
 public:
   void draw();
+  void getTransformation( GLfloat m[16] );
   Vector3 getOriginalView( void );
   Vector3 getOriginalUp( void );
   bool isDestroyed();
@@ -44,6 +45,8 @@ protected:
   void updateLaser( float t );
 public:
   virtual void update( float t);
+  virtual void steer( float t );
+  void updateSystems( float t );
 
   // shooting with laser and missiles
 public:
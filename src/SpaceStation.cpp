@@ -8,37 +8,37 @@
 
 //! Initializes the space station. 
 /**
- * The radius and the display list have to be 
+ * The radius and the mesh have to be 
  * submitted if an object is initialized. The starting position is set to the
  * origin.
  * \param r the radius
- * \param displayList the display list
+ * \param mesh the mesh
  */
-SpaceStation::SpaceStation( float r, GLuint displayList ) : SpinningObject( ), ModelObject( r, displayList ) {
+SpaceStation::SpaceStation( float r, Mesh *mesh ) : SpinningObject( ), ModelObject( r, mesh ) {
 }
 
 //! Initializes the space station. 
 /**
- * The radius and the display list have to be 
+ * The radius and the mesh have to be 
  * submitted if an object is initialized.
  * \param position the position as Vector3
  * \param r the radius
- * \param displayList the display list
+ * \param mesh the mesh
  */
-SpaceStation::SpaceStation( Vector3 position, float r, GLuint displayList ) : SpinningObject( position ), ModelObject( r, displayList ) {
+SpaceStation::SpaceStation( Vector3 position, float r, Mesh *mesh ) : SpinningObject( position ), ModelObject( r, mesh ) {
 }
 
 //! Initializes the space station. 
 /**
- * The radius and the display list have to be 
+ * The radius and the mesh have to be 
  * submitted if an object is initialized.
  * \param x the x-position
  * \param y the y-position
  * \param z the z-position
  * \param r the radius
- * \param displayList the display list
+ * \param mesh the mesh
  */
-SpaceStation::SpaceStation( float x, float y, float z, float r, GLuint displayList ) : SpinningObject( x, y, z ), ModelObject( r, displayList ) {
+SpaceStation::SpaceStation( float x, float y, float z, float r, Mesh *mesh ) : SpinningObject( x, y, z ), ModelObject( r, mesh ) {
 }
 
 /**
@@ -48,10 +48,14 @@ SpaceStation::~SpaceStation(void) {
 
 }
 
+//! Draws the station.
+/**
+ * The pose of the last update is used to place the model, so nothing has to be computed here.
+ */
 void SpaceStation::draw() {
+#ifndef MELITE_HEADLESS
   glPushMatrix();
-  glTranslatef( getPos().x, getPos().y, getPos().z );
-  this->spin();
+  glMultMatrixf( getPose() );
   ModelObject::draw();
 
   // zeichne nur viereck
@@ -67,6 +71,7 @@ void SpaceStation::draw() {
 
   glEnable( GL_TEXTURE_2D );
   glPopMatrix();
+#endif
 }
 
 Vector3 SpaceStation::getOutVector( void ) {
@@ -75,55 +80,10 @@ Vector3 SpaceStation::getOutVector( void ) {
   Vector3 bnt = Vector3( +10*factor,30*factor, 160*factor );
   Vector3 cnt = Vector3( -10*factor, -30*factor, 160*factor );
 
-  GLfloat m[4][4];// define memory space for a single matrix
-  glPushMatrix();
-  glLoadIdentity();
-  glTranslatef( getPos().x, getPos().y, getPos().z );
-  this->spin();
-  glGetFloatv( GL_MODELVIEW_MATRIX, &m[0][0] );// get the matrix
-  glPopMatrix();
-
-  float vectStart[4];
-  float vectResult[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
-
-  vectStart[0] = ant.x;
-  vectStart[1] = ant.y;
-  vectStart[2] = ant.z;
-  vectStart[3] = 1.0f;
-  for( int j =0; j<4; j++ ) {
-    float val = 0;
-    for( int i = 0; i<4; i++) {
-      val+= m[i][j]  * vectStart[i];
-    }
-    vectResult[j] = val;
-  }
-  Vector3 a = Vector3( vectResult[0], vectResult[1], vectResult[2] );
-
-  vectStart[0] = bnt.x;
-  vectStart[1] = bnt.y;
-  vectStart[2] = bnt.z;
-  vectStart[3] = 1.0f;
-  for( int j =0; j<4; j++ ) {
-    float val = 0;
-    for( int i = 0; i<4; i++) {
-      val+= m[i][j]  * vectStart[i];
-    }
-    vectResult[j] = val;
-  }
-  Vector3 b = Vector3( vectResult[0], vectResult[1], vectResult[2] );
-
-  vectStart[0] = cnt.x;
-  vectStart[1] = cnt.y;
-  vectStart[2] = cnt.z;
-  vectStart[3] = 1.0f;
-  for( int j =0; j<4; j++ ) {
-    float val = 0;
-    for( int i = 0; i<4; i++) {
-      val+= m[i][j]  * vectStart[i];
-    }
-    vectResult[j] = val;
-  }
-  Vector3 c = Vector3( vectResult[0], vectResult[1], vectResult[2] );
+  // transform the corners of the entrance with the pose of the last update
+  Vector3 a = transform( ant );
+  Vector3 b = transform( bnt );
+  Vector3 c = transform( cnt );
 
   Plane p = Plane( a, c, b );
   Vector3 ret = p.getNormal();
@@ -136,29 +96,7 @@ Vector3 SpaceStation::getOutPosition( void ) {
 
   Vector3 cnt = Vector3( 0,0, 160*factor );
 
-  GLfloat m[4][4];// define memory space for a single matrix
-  glPushMatrix();
-  glLoadIdentity();
-  glTranslatef( getPos().x, getPos().y, getPos().z );
-  this->spin();
-  glGetFloatv( GL_MODELVIEW_MATRIX, &m[0][0] );// get the matrix
-  glPopMatrix();
-
-  float vectStart[4];
-  float vectResult[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
-
-  vectStart[0] = cnt.x;
-  vectStart[1] = cnt.y;
-  vectStart[2] = cnt.z;
-  vectStart[3] = 1.0f;
-  for( int j =0; j<4; j++ ) {
-    float val = 0;
-    for( int i = 0; i<4; i++) {
-      val+= m[i][j]  * vectStart[i];
-    }
-    vectResult[j] = val;
-  }
-  Vector3 c = Vector3( vectResult[0], vectResult[1], vectResult[2] );
+  Vector3 c = transform( cnt );
 
   // c is the point in the center of the coriolis station
 
@@ -176,110 +114,14 @@ bool SpaceStation::test( const Vector3 &position ) {
   Vector3 cnt2 = Vector3( -10*factor, -30*factor, -160*factor );
   //Vector3 dnt2 = Vector3( +10*factor, -30*factor, -160*factor );
 
-  GLfloat m[4][4];// define memory space for a single matrix
-  glPushMatrix();
-  glLoadIdentity();
-  glTranslatef( getPos().x, getPos().y, getPos().z );
-  this->spin();
-  glGetFloatv( GL_MODELVIEW_MATRIX, &m[0][0] );// get the matrix
-  glPopMatrix();
-
-  float vectStart[4];
-  float vectResult[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
-
-  vectStart[0] = ant.x;
-  vectStart[1] = ant.y;
-  vectStart[2] = ant.z;
-  vectStart[3] = 1.0f;
-  for( int j =0; j<4; j++ ) {
-    float val = 0;
-    for( int i = 0; i<4; i++) {
-      val+= m[i][j]  * vectStart[i];
-    }
-    vectResult[j] = val;
-  }
-  Vector3 a = Vector3( vectResult[0], vectResult[1], vectResult[2] );
-
-  vectStart[0] = bnt.x;
-  vectStart[1] = bnt.y;
-  vectStart[2] = bnt.z;
-  vectStart[3] = 1.0f;
-  for( int j =0; j<4; j++ ) {
-    float val = 0;
-    for( int i = 0; i<4; i++) {
-      val+= m[i][j]  * vectStart[i];
-    }
-    vectResult[j] = val;
-  }
-  Vector3 b = Vector3( vectResult[0], vectResult[1], vectResult[2] );
-
-  vectStart[0] = cnt.x;
-  vectStart[1] = cnt.y;
-  vectStart[2] = cnt.z;
-  vectStart[3] = 1.0f;
-  for( int j =0; j<4; j++ ) {
-    float val = 0;
-    for( int i = 0; i<4; i++) {
-      val+= m[i][j]  * vectStart[i];
-    }
-    vectResult[j] = val;
-  }
-  Vector3 c = Vector3( vectResult[0], vectResult[1], vectResult[2] );
-
-  vectStart[0] = dnt.x;
-  vectStart[1] = dnt.y;
-  vectStart[2] = dnt.z;
-  vectStart[3] = 1.0f;
-  for( int j =0; j<4; j++ ) {
-    float val = 0;
-    for( int i = 0; i<4; i++) {
-      val+= m[i][j]  * vectStart[i];
-    }
-    vectResult[j] = val;
-  }
-  Vector3 d = Vector3( vectResult[0], vectResult[1], vectResult[2] );
-
-
-
-
-  vectStart[0] = ant2.x;
-  vectStart[1] = ant2.y;
-  vectStart[2] = ant2.z;
-  vectStart[3] = 1.0f;
-  for( int j =0; j<4; j++ ) {
-    float val = 0;
-    for( int i = 0; i<4; i++) {
-      val+= m[i][j]  * vectStart[i];
-    }
-    vectResult[j] = val;
-  }
-  Vector3 a2 = Vector3( vectResult[0], vectResult[1], vectResult[2] );
-
-  vectStart[0] = bnt2.x;
-  vectStart[1] = bnt2.y;
-  vectStart[2] = bnt2.z;
-  vectStart[3] = 1.0f;
-  for( int j =0; j<4; j++ ) {
-    float val = 0;
-    for( int i = 0; i<4; i++) {
-      val+= m[i][j]  * vectStart[i];
-    }
-    vectResult[j] = val;
-  }
-  Vector3 b2 = Vector3( vectResult[0], vectResult[1], vectResult[2] );
-
-  vectStart[0] = cnt2.x;
-  vectStart[1] = cnt2.y;
-  vectStart[2] = cnt2.z;
-  vectStart[3] = 1.0f;
-  for( int j =0; j<4; j++ ) {
-    float val = 0;
-    for( int i = 0; i<4; i++) {
-      val+= m[i][j]  * vectStart[i];
-    }
-    vectResult[j] = val;
-  }
-  Vector3 c2 = Vector3( vectResult[0], vectResult[1], vectResult[2] );
+  // transform the corners with the pose of the last update
+  Vector3 a = transform( ant );
+  Vector3 b = transform( bnt );
+  Vector3 c = transform( cnt );
+  Vector3 d = transform( dnt );
+  Vector3 a2 = transform( ant2 );
+  Vector3 b2 = transform( bnt2 );
+  Vector3 c2 = transform( cnt2 );
 
 
   // works without rotating ;)
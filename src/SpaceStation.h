@@ -18,9 +18,9 @@
 class SpaceStation :
   public SpinningObject, public ModelObject {
 public:
-  SpaceStation( float r, GLuint displayList );
-  SpaceStation( Vector3 position, float r, GLuint displayList );
-  SpaceStation( float x, float y, float z, float r, GLuint displayList );
+  SpaceStation( float r, Mesh *mesh );
+  SpaceStation( Vector3 position, float r, Mesh *mesh );
+  SpaceStation( float x, float y, float z, float r, Mesh *mesh );
   ~SpaceStation( void );
   // flying into the station
 public:
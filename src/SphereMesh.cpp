@@ -0,0 +1,85 @@
+/**
+ * Copyright Jan-Philipp Kappmeier, Melanie Schmidt
+ * \file	SphereMesh.cpp
+ * \brief	Implementation of the sphere cache.
+ */
+#include "SphereMesh.h"
+#include "Frustum.h"
+
+// slices and stacks of the levels of detail, 32 x 32 equals the former spheres
+static const GLint levelSlices[SphereMesh::levelCount] = { 32, 16, 10, 6 };
+static const GLint levelStacks[SphereMesh::levelCount] = { 32, 16, 8, 5 };
+// the smallest part of the screen height a sphere has to cover to be drawn with a level
+static const float levelSizes[SphereMesh::levelCount] = { 0.2f, 0.05f, 0.0125f, 0.0f };
+
+GLuint SphereMesh::lists[SphereMesh::levelCount] = { 0 };
+Frustum *SphereMesh::frustum = 0;
+
+SphereMesh::SphereMesh( void ) {
+}
+
+SphereMesh::~SphereMesh( void ) {
+}
+
+//! Draws a textured sphere at the origin.
+/**
+ * The poles are on the z-axis and the texture is wrapped around it, as done by
+ * gluSphere. The list of the level is compiled when it is drawn the first time.
+ * \param radius the radius of the sphere
+ * \param level the level of detail, 0 is the finest
+ */
+void SphereMesh::draw( GLfloat radius, unsigned int level ) {
+  if( level >= levelCount )
+    level = levelCount - 1;
+  if( lists[level] == 0 ) {
+    GLUquadricObj *quadObj = gluNewQuadric();
+    gluQuadricDrawStyle( quadObj, GLU_FILL );
+    gluQuadricTexture( quadObj, GL_TRUE );
+    lists[level] = glGenLists( 1 );
+    glNewList( lists[level], GL_COMPILE );
+    gluSphere( quadObj, 1, levelSlices[level], levelStacks[level] );
+    glEndList();
+    gluDeleteQuadric( quadObj );
+  }
+  glPushAttrib( GL_ENABLE_BIT );
+  glEnable( GL_NORMALIZE );
+  glPushMatrix();
+  glScalef( radius, radius, radius );
+  glCallList( lists[level] );
+  glPopMatrix();
+  glPopAttrib();
+}
+
+//! Chooses the level of detail for a sphere.
+/**
+ * \param pos the center of the sphere in world coordinates
+ * \param radius the radius of the sphere
+ * \return the coarsest level that is fine enough for the size of the sphere on the screen, 0 if no frustum is set
+ */
+unsigned int SphereMesh::getLevel( const Vector3 &pos, GLfloat radius ) {
+  if( frustum == 0 )
+    return 0;
+  float size = frustum->getProjectedSize( pos, radius );
+  unsigned int level = 0;
+  while( level < levelCount - 1 && size < levelSizes[level] )
+    level++;
+  return level;
+}
+
+/**
+ * \brief Sets the frustum used to choose the level of detail, or 0 to draw all spheres with the finest level.
+ */
+void SphereMesh::setFrustum( Frustum *frustum ) {
+  SphereMesh::frustum = frustum;
+}
+
+/**
+ * \brief Deletes the display lists. Has to be called while the rendering context is current.
+ */
+void SphereMesh::release( void ) {
+  for( unsigned int i = 0; i < levelCount; i++ ) {
+    if( lists[i] != 0 )
+      glDeleteLists( lists[i], 1 );
+    lists[i] = 0;
+  }
+}
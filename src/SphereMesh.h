@@ -0,0 +1,40 @@
+/**
+ * Copyright Jan-Philipp Kappmeier, Melanie Schmidt
+ * \file	SphereMesh.h
+ * \brief	Declares the SphereMesh class, a cache of textured spheres in several levels of detail.
+ */
+#pragma once
+
+#include "GlobalGL.h"
+#include "Vector3.h"
+
+class Frustum;
+
+//! Draws textured spheres from display lists shared by all planets and stars.
+/**
+ * A unit sphere is compiled once for each level of detail, with the same texture
+ * coordinates and normals as gluSphere. A sphere is drawn by scaling the list to its
+ * radius; as the normals are scaled, too, they are normalized while drawing. Level 0
+ * has 32 slices and stacks like the spheres drawn before. Each further level has fewer
+ * slices and stacks, the first ones half as many, so it has roughly a quarter to a third
+ * of the triangles of the level before, until the last one has less than fifty.
+ *
+ * If a frustum is set, the level is chosen by the size of the sphere on the screen,
+ * which is computed from the distance to the eye point of the frustum. Otherwise level
+ * 0 is used. The lists have to be freed with release() before the rendering context
+ * is destroyed.
+ */
+class SphereMesh {
+public:
+  static const unsigned int levelCount = 4;
+  static void draw( GLfloat radius, unsigned int level );
+  static unsigned int getLevel( const Vector3 &pos, GLfloat radius );
+  static void setFrustum( Frustum *frustum );
+  static void release( void );
+private:
+  SphereMesh( void );
+  ~SphereMesh( void );
+
+  static GLuint lists[levelCount];
+  static Frustum *frustum;
+};
@@ -14,6 +14,7 @@ SpinningObject::SpinningObject( ) : GameObject( ) {
   m_axis.y = 1;
   m_axis.z = 0;
   m_speed = 0;
+  updatePose( 0 );
 }
 
 /**
@@ -25,6 +26,7 @@ SpinningObject::SpinningObject( Vector3 position ) : GameObject( position ) {
   m_axis.y = 1;
   m_axis.z = 0;
   m_speed = 0;
+  updatePose( 0 );
 }
 
 /**
@@ -38,6 +40,7 @@ SpinningObject::SpinningObject( GLfloat x, GLfloat y, GLfloat z ) : GameObject(
   m_axis.y = 1;
   m_axis.z = 0;
   m_speed = 0;
+  updatePose( 0 );
 }
 
 /**
@@ -75,8 +78,60 @@ void SpinningObject::setSpeed( float speed ) {
 }
 
 /**
- * Rotates the object using the glRotate*() function.
+ * Rotates the object using the glRotate*() function. The angle is the one of
+ * the last call of updatePose().
  */
 void SpinningObject::spin( void ) {
-  glRotatef( glutGet(GLUT_ELAPSED_TIME)  * m_speed, m_axis.x, m_axis.y, m_axis.z ); // rotation for a day
+#ifndef MELITE_HEADLESS
+  glRotatef( m_spinAngle, m_axis.x, m_axis.y, m_axis.z ); // rotation for a day
+#endif
+}
+
+//! Computes the transformation of the object for a given time.
+/**
+ * The pose is the translation to the current position followed by the spin
+ * about the axis, as it would be set up by glTranslatef() and spin(). It is
+ * computed directly, so no OpenGL context is needed. Should be called once in
+ * each update of the simulation.
+ * \param time the time in milliseconds
+ */
+void SpinningObject::updatePose( long time ) {
+  m_spinAngle = time * m_speed;
+
+  // rotation matrix as used by glRotatef
+  Vector3 axis = m_axis;
+  float x = 0, y = 0, z = 0, c = 1, s = 0;
+  if( axis.length() > 0 ) {
+    axis.normalize();
+    x = axis.x;
+    y = axis.y;
+    z = axis.z;
+    c = cos( m_spinAngle * ANGLE2DEG );
+    s = sin( m_spinAngle * ANGLE2DEG );
+  }
+  Vector3 pos = getPos();
+
+  m_pose[0] = x*x*(1-c)+c;   m_pose[4] = x*y*(1-c)-z*s; m_pose[8] = x*z*(1-c)+y*s;  m_pose[12] = pos.x;
+  m_pose[1] = y*x*(1-c)+z*s; m_pose[5] = y*y*(1-c)+c;   m_pose[9] = y*z*(1-c)-x*s;  m_pose[13] = pos.y;
+  m_pose[2] = x*z*(1-c)-y*s; m_pose[6] = y*z*(1-c)+x*s; m_pose[10] = z*z*(1-c)+c;   m_pose[14] = pos.z;
+  m_pose[3] = 0;             m_pose[7] = 0;             m_pose[11] = 0;             m_pose[15] = 1;
+}
+
+/**
+ * \brief Returns the transformation of the last update in the column major order used by OpenGL.
+ */
+const GLfloat * SpinningObject::getPose( void ) {
+  return m_pose;
+}
+
+//! Transforms a point from object coordinates into world coordinates.
+/**
+ * The pose of the last call of updatePose() is used.
+ * \param point the point in object coordinates
+ * \return the point in world coordinates
+ */
+Vector3 SpinningObject::transform( const Vector3 &point ) {
+  return Vector3( m_pose[0]*point.x + m_pose[4]*point.y + m_pose[8]*point.z + m_pose[12],
+    m_pose[1]*point.x + m_pose[5]*point.y + m_pose[9]*point.z + m_pose[13],
+    m_pose[2]*point.x + m_pose[6]*point.y + m_pose[10]*point.z + m_pose[14] );
 }
\ No newline at end of file
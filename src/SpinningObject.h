@@ -6,7 +6,7 @@
 #pragma once
 #include "GlobalGL.h"
 #include "GraphicsObject.h"
-#include "Vectormath.h"
+#include "VectorMath.h"
 #include "Vector3.h"
 
 //! Implements a simple spinning object.
@@ -30,7 +30,15 @@ public:
   void setAxis( float x, float y, float z );
   void setSpeed( float speed );
   void spin( void );
+
+  // pose
+public:
+  void updatePose( long time );
+  const GLfloat * getPose( void );
+  Vector3 transform( const Vector3 &point );
 private:
   Vector3 m_axis;
   float m_speed;
+  float m_spinAngle;// the angle in degrees at the time of the last update
+  GLfloat m_pose[16];// translation and spin at the time of the last update, column major
 };
\ No newline at end of file
@@ -23,8 +23,7 @@ GraphicsObject( collisionRadius ) {
   m_lightColor.x = 1.0;
   m_lightColor.y = 1.0;
   m_lightColor.z = 0.0;
-  glLightfv( GL_LIGHT0, GL_POSITION, m_lightPosition )
-    ;}
+}
 
 //! Draws a star, which is basically only a planet with light. 
 /**
@@ -45,7 +44,6 @@ GraphicsObject( planetRadius ) {
   m_lightColor.x = 1.0;
   m_lightColor.y = 1.0;
   m_lightColor.z = 0.0;
-  glLightfv( GL_LIGHT0, GL_POSITION, m_lightPosition );
 }
 
 /**
@@ -60,7 +58,7 @@ GraphicsObject( planetRadius ) {
  */
 Star::Star( float x, float y, float z, float planetRadius, float collisionRadius, GLuint textureName )
 : Planet( x, y, z, planetRadius, collisionRadius, textureName ),
-GameObject( x, z, z ),
+GameObject( x, y, z ),
 GraphicsObject( collisionRadius ) {
   m_lightPosition[0] = 0.0;
   m_lightPosition[1] = 0.0;
@@ -69,7 +67,6 @@ GraphicsObject( collisionRadius ) {
   m_lightColor.x = 1.0;
   m_lightColor.y = 1.0;
   m_lightColor.z = 0.0;
-  glLightfv( GL_LIGHT0, GL_POSITION, m_lightPosition );
 }
 
 /**
@@ -81,9 +78,11 @@ Star::~Star(void) {
 //! Draws a star
 /**
  * This drawing function uses the base planet function to draw the sun. Before
- * this the light is color is set.
+ * this the light is positioned and the color is set.
  */
 GLvoid Star::draw() {
+#ifndef MELITE_HEADLESS
+  setLight();
   glPushAttrib( GL_ALL_ATTRIB_BITS );
   float color[3];
   color[0] = m_lightColor.x;
@@ -92,6 +91,7 @@ GLvoid Star::draw() {
   glMaterialfv( GL_FRONT, GL_EMISSION, color );
   Planet::draw();
   glPopAttrib();
+#endif
 }
 
 /**
@@ -119,9 +119,20 @@ GLvoid Star::setPos( GLfloat x, GLfloat y, GLfloat z ) {
   m_lightPosition[0] = x;
   m_lightPosition[1] = y;
   m_lightPosition[2] = z;
-  glLightfv( GL_LIGHT0, GL_POSITION, m_lightPosition );
 }
 
 GLvoid Star::setPos( Vector3 position ) {
   this->setPos( position.x, position.y, position.z );
 }
+
+//! Places the light of the star.
+/**
+ * The light position is transformed by the current modelview matrix, so the
+ * function has to be called after the camera is set up. This is done when the
+ * star is drawn, but has also to be done if the star is culled.
+ */
+GLvoid Star::setLight( GLvoid ) {
+#ifndef MELITE_HEADLESS
+  glLightfv( GL_LIGHT0, GL_POSITION, m_lightPosition );
+#endif
+}
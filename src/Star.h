@@ -5,7 +5,7 @@
  */
 #pragma once
 #include "Planet.h"
-#include "Vectormath.h"
+#include "VectorMath.h"
 
 //! A Star is a special type of Planet that has supports lighting.
 class Star :
@@ -16,6 +16,7 @@ public:
   Star( float x, float y, float z, float planetRadius, float collisionRadius, GLuint textureName );
   ~Star(void);
   GLvoid draw( GLvoid );
+  GLvoid setLight( GLvoid );
   GLvoid setLightColor( Vector3 lightColor );
   GLvoid setLightColor( float r, float g, float b );
   GLvoid setPos( GLfloat x, GLfloat y, GLfloat z );
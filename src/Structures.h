@@ -10,6 +10,8 @@
 #include "wrappDef.h"
 #include "Vector3.h"
 
+class Mesh;
+
 struct PlayerStatus {
   PlayerStatus() : fuel(0), cash(0) {}
   double fuel;
@@ -199,11 +201,38 @@ enum ObjectName {
   tieDroid
 };
 
+/**
+ * \brief The concrete types of space ships stored in the world.
+ *
+ * The type is stored together with each ship, so that ships can be deleted and
+ * sorted into the typed lists without runtime type information.
+ */
+enum ShipType {
+  genericShip = 0,
+  pirateShip,
+  thargonShip,
+  merchantShip,
+  policeShip
+};
+
+/**
+ * \brief A stable reference to a space ship in the world.
+ *
+ * Contains the index of the ship in the ship table and the generation of the table entry. The
+ * generation is increased if a ship is removed, so that old handles become invalid instead of
+ * referencing the next ship that is stored at the same position.
+ */
+struct ShipHandle {
+  ShipHandle() : index( 0xffffffff ), generation( 0 ) {}
+  unsigned int index;
+  unsigned int generation;
+};
+
 struct ObjectInfo {
-  ObjectInfo() : filename(""), object(-1), displayList(0), view(0,0,1) {}
+  ObjectInfo() : filename(""), object(-1), mesh(0), view(0,0,1) {}
   int object;
   std::string filename;
-  GLuint displayList;
+  Mesh *mesh;
   Vector3 view;
 };
 
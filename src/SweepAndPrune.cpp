@@ -0,0 +1,117 @@
+/**
+ * Copyright Jan-Philipp Kappmeier, Melanie Schmidt
+ * \file	SweepAndPrune.cpp
+ * \brief	Implementation of the sweep and prune broad phase.
+ */
+#include "SweepAndPrune.h"
+#include <algorithm>
+#include <math.h>
+
+using namespace std;
+
+SweepAndPrune::SweepAndPrune( void ) {
+}
+
+SweepAndPrune::~SweepAndPrune( void ) {
+}
+
+/**
+ * \brief Removes all spheres. The reserved memory is kept for the next update.
+ */
+void SweepAndPrune::clear( void ) {
+  entries.clear();
+}
+
+//! Inserts a sphere.
+/**
+ * The sphere is not sorted into the list until update() is called.
+ * \param pos the center of the sphere
+ * \param radius the radius of the sphere
+ * \param id an id that identifies the object in the returned pairs
+ */
+void SweepAndPrune::insert( const Vector3 &pos, float radius, unsigned int id ) {
+  Entry e;
+  e.min = pos.x - radius;
+  e.max = pos.x + radius;
+  e.pos = pos;
+  e.radius = radius;
+  e.id = id;
+  entries.push_back( e );
+}
+
+//! Sorts the inserted spheres by the lower end of their intervals.
+void SweepAndPrune::update( void ) {
+  sort( entries.begin(), entries.end() );
+}
+
+/**
+ * \brief Returns the number of inserted spheres.
+ */
+unsigned int SweepAndPrune::size( void ) {
+  return (unsigned int)entries.size();
+}
+
+//! Finds all pairs of intersecting spheres.
+/**
+ * Sweeps through the sorted list. The inner loop stops at the first sphere whose interval starts
+ * behind the end of the current interval, as all further spheres start even later. The candidates
+ * are tested exactly by comparing the squared distance of the centers to the squared sum of the
+ * radii. Touching spheres count as intersecting.
+ * \param pairs the found pairs are appended to this vector
+ */
+void SweepAndPrune::findPairs( vector<CollisionPair> &pairs ) {
+  for( unsigned int i=0; i < entries.size(); i++ ) {
+    const Entry &a = entries[i];
+    for( unsigned int j=i+1; j < entries.size() && entries[j].min <= a.max; j++ ) {
+      const Entry &b = entries[j];
+      float dx = a.pos.x - b.pos.x;
+      float dy = a.pos.y - b.pos.y;
+      float dz = a.pos.z - b.pos.z;
+      float r = a.radius + b.radius;
+      if( dx*dx + dy*dy + dz*dz <= r*r )
+        pairs.push_back( CollisionPair( a.id, b.id ) );
+    }
+  }
+}
+
+//! Finds all spheres that are hit by a ray, sorted by their distance to the origin.
+/**
+ * The ray covers an interval on the x-axis. The sweep stops at the first sphere whose interval starts
+ * behind it, spheres whose interval ends before it are skipped. The candidates are tested exactly by
+ * projecting the center onto the ray. If the origin lies inside a sphere, the sphere is hit with
+ * distance zero.
+ * \param origin the start point of the ray
+ * \param direction the direction of the ray, needs not to be normalized
+ * \param maxDistance the length of the ray
+ * \param ignoreId the id of an object that is not hit, e. g. the shooting object
+ * \param hits the hits are appended to this vector, the new hits are sorted by distance
+ */
+void SweepAndPrune::castRay( const Vector3 &origin, const Vector3 &direction, float maxDistance, unsigned int ignoreId, vector<RayHit> &hits ) {
+  Vector3 d = direction;
+  d.normalize();
+  float end = origin.x + d.x * maxDistance;
+  float rayMin = min( origin.x, end );
+  float rayMax = max( origin.x, end );
+
+  const size_t first = hits.size();
+  for( unsigned int i=0; i < entries.size() && entries[i].min <= rayMax; i++ ) {
+    const Entry &e = entries[i];
+    if( e.max < rayMin || e.id == ignoreId )
+      continue;
+    float ux = e.pos.x - origin.x;
+    float uy = e.pos.y - origin.y;
+    float uz = e.pos.z - origin.z;
+    float t = ux*d.x + uy*d.y + uz*d.z;  // distance of the projected center from the origin
+    float squaredToRay = ux*ux + uy*uy + uz*uz - t*t;
+    float r2 = e.radius * e.radius;
+    if( squaredToRay > r2 )
+      continue;
+    float h = sqrt( r2 - squaredToRay );
+    if( t + h < 0 )
+      continue; // the sphere lies behind the origin
+    float distance = t - h < 0 ? 0 : t - h;
+    if( distance <= maxDistance )
+      hits.push_back( RayHit( e.id, distance ) );
+  }
+  sort( hits.begin() + first, hits.end() );
+}
@@ -0,0 +1,71 @@
+/**
+ * Copyright Jan-Philipp Kappmeier, Melanie Schmidt
+ * \file	SweepAndPrune.h
+ * \brief	Declares a broad phase for collision tests of spheres using sweep and prune.
+ */
+#pragma once
+
+#include "Vector3.h"
+#include <vector>
+
+/**
+ * \brief A pair of objects whose collision spheres intersect.
+ *
+ * The objects are identified by the ids that were submitted when they were inserted.
+ */
+struct CollisionPair {
+  CollisionPair() : first( 0 ), second( 0 ) {}
+  CollisionPair( unsigned int f, unsigned int s ) : first( f ), second( s ) {}
+  unsigned int first;
+  unsigned int second;
+};
+
+/**
+ * \brief An object whose collision sphere is hit by a ray.
+ *
+ * The object is identified by the id that was submitted when it was inserted. The distance is
+ * measured from the origin of the ray to the point where it enters the sphere.
+ */
+struct RayHit {
+  RayHit() : id( 0 ), distance( 0 ) {}
+  RayHit( unsigned int i, float d ) : id( i ), distance( d ) {}
+  unsigned int id;
+  float distance;
+  bool operator <( const RayHit &h ) const { return distance < h.distance; }
+};
+
+//! A broad phase for the collision detection of spheres.
+/**
+ * All spheres are projected onto the x-axis and sorted by the lower end of their interval. Walking
+ * through the sorted list, a sphere has only to be tested against the following spheres whose interval
+ * starts before its own interval ends. Only these candidates are tested exactly, which is done using
+ * squared distances. The index is meant to be rebuilt in each update: clear it, insert all objects and
+ * call update() to sort them.
+ *
+ * Rays are tested the same way: only spheres whose interval overlaps the interval that the ray covers
+ * on the x-axis are tested exactly.
+ */
+class SweepAndPrune {
+public:
+  SweepAndPrune( void );
+  ~SweepAndPrune( void );
+
+  void clear( void );
+  void insert( const Vector3 &pos, float radius, unsigned int id );
+  void update( void );
+  unsigned int size( void );
+
+  void findPairs( std::vector<CollisionPair> &pairs );
+  void castRay( const Vector3 &origin, const Vector3 &direction, float maxDistance, unsigned int ignoreId, std::vector<RayHit> &hits );
+private:
+  //! A sphere, together with its interval on the x-axis.
+  struct Entry {
+    float min;
+    float max;
+    Vector3 pos;
+    float radius;
+    unsigned int id;
+    bool operator <( const Entry &e ) const { return min < e.min; }
+  };
+  std::vector<Entry> entries;
+};
@@ -0,0 +1,51 @@
+/**
+ * Copyright Jan-Philipp Kappmeier, Melanie Schmidt
+ * \file	TextureBaker.cpp
+ * \brief	Defines the main function of the texture baker, a build tool creating the texture containers.
+ */
+#ifdef MELITE_TEXTURE_BAKER
+#include "TextureLoaderBMP.h"
+#include "TextureLoaderTGA.h"
+#include "TextureLoaderMIP.h"
+#include "LittleHelper.h"
+#include <stdio.h>
+
+using namespace std;
+
+/**
+ * \fn	int main( int argc, char *argv[] )
+ *
+ * \brief	Creates a texture container with all mipmap levels for each given image.
+ *
+ * The images are loaded with the same loaders and settings as in the game, so the
+ * containers have the same color order. A container is stored next to its image with
+ * the ending mip, where Textures::decodeTexture() prefers it to the image. The baker
+ * has to be run again if an image changes, until then the image is loaded instead.
+ *
+ * \param argc number of arguments
+ * \param argv the bmp and tga files
+ *
+ * \return the number of files that could not be converted
+ */
+int main( int argc, char *argv[] ) {
+  int errors = 0;
+  for( int i=1; i < argc; i++ ) {
+    string filename( argv[i] );
+    TextureLoader *loader = 0;
+    if( LittleHelper::stringCmpi( filename.substr(filename.length() - 3, 3), "bmp" ) == 0)
+      loader = new TextureLoaderBMP();
+    if( LittleHelper::stringCmpi( filename.substr(filename.length() - 3, 3), "tga" ) == 0)
+      loader = new TextureLoaderTGA();
+
+    TextureLoaderMIP container;
+    string containerFile = TextureLoaderMIP::getContainerFile( filename );
+    if( loader == 0 || !loader->load( filename ) || !container.build( *loader, filename ) || !container.write( containerFile ) ) {
+      printf( "%s: failed\n", filename.c_str() );
+      errors++;
+    } else
+      printf( "%s: %u x %u, %u levels\n", containerFile.c_str(), container.getWidth(), container.getHeight(), container.getLevelCount() );
+    delete loader;
+  }
+  return errors;
+}
+#endif
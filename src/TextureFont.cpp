@@ -6,6 +6,11 @@
 #include "GlobalParameters.h"
 #include "TextureFont.h"
 #include "Textures.h"
+#include <string.h>
+
+// texts are laid out again if more different texts than this were printed, which
+// happens if numbers that change each frame are printed
+static const unsigned int maxLayouts = 256;
 
 /**
  * \brief Builds a TextureFont, that is independent of the operating system.
@@ -14,6 +19,8 @@ TextureFont::TextureFont( GLuint texindex ) {
   texture = texindex; // texture index for the font texture
   count = 0;
   m_size = 0;
+  m_width = 0;
+  batching = false;
 }
 
 /**
@@ -38,29 +45,17 @@ GLvoid TextureFont::buildFont( GLuint cpl, GLuint cpr, GLuint size, GLuint targe
   float	cy;								// character y coordinates
 
   count = cpr  * cpl;
-  base = glGenLists( count );							 // create a display list big enough for all characters
-  //glBindTexture( GL_TEXTURE_2D, texture );				// select the font texture
-   Textures::getTextures()->bindTexture( texture );
+  glyphs.resize( count * 4 );
+  layouts.clear();
 
   for( unsigned int i=0; i < count; i++ ) {
     cx = float(i%size)/(float)cpl;			 // x position of current character (left)
     cy = float(i/size)/(float)cpr;					// y position of current character (top)	
 
-    glNewList( base + i, GL_COMPILE );				// create a listelement
-
-    glBegin( GL_QUADS );					// each character is a quad
-    glTexCoord2f( cx, 1-cy-(1/(float)cpr) );			// texture coordinates bottom left
-    glVertex2i( 0, 0 );				// vertex coordinates bottom left
-    glTexCoord2f( cx + (1/(float)cpl), 1-cy-(1/(float)cpr));	// texture coordinates bottom right
-    glVertex2i( targetsize, 0 );				// vertex coordinates bottom right
-    glTexCoord2f( cx + (1/(float)cpl), 1-cy);			// texture coordinates top right
-    glVertex2i( targetsize, targetsize );				// vertex coordinates top right
-    glTexCoord2f( cx, 1-cy );				 // texture coordinates top left
-    glVertex2i( 0, targetsize );				// vertex coordinates top left
-    glEnd();
-
-    glTranslated( skipspace, 0, 0 );	// each character is only 10 pixels wide, move to the right
-    glEndList();							 // finish list
+    glyphs[i*4] = cx;
+    glyphs[i*4+1] = 1-cy-(1/(float)cpr);
+    glyphs[i*4+2] = cx + (1/(float)cpl);
+    glyphs[i*4+3] = 1-cy;
   }
 }
 
@@ -75,16 +70,20 @@ unsigned int TextureFont::getWidth( void ) {
 }
 
 /**
- * \brief Deletes the displaylists for all 96 characters.
+ * \brief Deletes the texture coordinates of all characters and the laid out texts.
  */
 GLvoid TextureFont::killFont( GLvoid ) {
-  glDeleteLists( base, count );						// delete all caracters
+  glyphs.clear();
+  layouts.clear();
+  batch.clear();
+  count = 0;
 }
 
 //! Prints a text to the screen.
 /**
  * The text is allowed to be up to 256 chars. It
- * is assumed that the current projection is an orthogonal projection.
+ * is assumed that the current projection is an orthogonal projection. The text gets
+ * the current color. If begin() was called, the text is drawn by the next flush().
  * \param x x-position where the text starts
  * \param y y-position where the text starts
  * \param string pointer to a char array with the text to be printed
@@ -100,25 +99,107 @@ GLvoid TextureFont::print( int x, int y, const char *string, ... ) {
   vsprintf_s( text, string, ap );		// convert symbols to actual numbers
   va_end( ap );						 // store results in text
 
-  //glBindTexture( GL_TEXTURE_2D, texture );				// select font texture
-   Textures::getTextures()->bindTexture( texture );
-
-  glPushMatrix();
-  glPushAttrib( GL_LIST_BIT );				// push display list bits
-  glTranslated( x, y, 0 );							// textposition (0,0 - Bottom Left)
-  glListBase( base - 32 );
-
-  glCallLists( (int)strlen(text), GL_UNSIGNED_BYTE, text );			// print text to screen
-  glPopAttrib();
-  glPopMatrix();
+  add( x, y, text );
 }
 
 //! Prints a text to the screen.
-/**s
+/**
+ * The text is not parsed for variables.
  * \param x the x-coordinate where the text starts
  * \param y the y-coordinate where the text starts
  * \param text the text
  */
 void TextureFont::print( int x, int y, const std::string *text ) {
-  print(x, y, text->c_str());
+  add( x, y, *text );
+}
+
+//! Starts collecting texts.
+/**
+ * All texts printed until flush() is called are drawn at once. The modelview and
+ * projection matrix must not change in between, as all texts are drawn with the
+ * matrices that are set when flush() is called.
+ */
+void TextureFont::begin( void ) {
+  batching = true;
+}
+
+//! Draws all collected texts with one call and stops collecting.
+/**
+ * The font texture is bound, other states like blending are used as they are set.
+ * The current color is not changed.
+ */
+void TextureFont::flush( void ) {
+  batching = false;
+  if( batch.empty() )
+    return;
+  GLfloat color[4];
+  glGetFloatv( GL_CURRENT_COLOR, color );
+  Textures::getTextures()->bindTexture( texture );
+
+  glPushClientAttrib( GL_CLIENT_VERTEX_ARRAY_BIT );
+  glInterleavedArrays( GL_T2F_C4UB_V3F, 0, &batch[0] );
+  glDrawArrays( GL_QUADS, 0, (GLsizei)batch.size() );
+  glPopClientAttrib();
+
+  glColor4fv( color ); // the color is undefined after drawing with a color array
+  batch.clear();
+}
+
+//! Adds the quads of a text in the current color to the collected texts.
+/**
+ * If no texts are collected, the text is drawn immediately.
+ * \param x the x-coordinate where the text starts
+ * \param y the y-coordinate where the text starts
+ * \param text the text
+ */
+void TextureFont::add( int x, int y, const std::string &text ) {
+  const Layout &layout = getLayout( text );
+  GLfloat current[4];
+  glGetFloatv( GL_CURRENT_COLOR, current );
+  GLubyte color[4];
+  for( unsigned int i = 0; i < 4; i++ )
+    color[i] = (GLubyte)(current[i] * 255 + 0.5f);
+
+  size_t first = batch.size();
+  batch.insert( batch.end(), layout.begin(), layout.end() );
+  for( size_t i = first; i < batch.size(); i++ ) {
+    batch[i].x += x;
+    batch[i].y += y;
+    memcpy( batch[i].color, color, 4 );
+  }
+  if( !batching )
+    flush();
+}
+
+//! Returns the quads of a text starting at the origin.
+/**
+ * The quads are computed when the text is printed the first time. Characters that
+ * are not contained in the font are skipped.
+ * \param text the text
+ * \return the four corners of each character, counterclockwise starting bottom left
+ */
+const TextureFont::Layout & TextureFont::getLayout( const std::string &text ) {
+  std::map<std::string, Layout>::iterator it = layouts.find( text );
+  if( it != layouts.end() )
+    return it->second;
+  if( layouts.size() >= maxLayouts )
+    layouts.clear();
+
+  Layout &layout = layouts[text];
+  layout.reserve( text.length() * 4 );
+  Vertex v;
+  memset( &v, 0, sizeof( Vertex ) );
+  float left = 0;
+  for( size_t i = 0; i < text.length(); i++ ) {
+    unsigned int c = (unsigned char)text[i];
+    if( c < 32 || c - 32 >= count ) // no display list existed for these characters
+      continue;
+    const GLfloat *glyph = &glyphs[(c - 32) * 4];
+    v.s = glyph[0]; v.t = glyph[1]; v.x = left;          v.y = 0;      layout.push_back( v );
+    v.s = glyph[2]; v.t = glyph[1]; v.x = left + m_size; v.y = 0;      layout.push_back( v );
+    v.s = glyph[2]; v.t = glyph[3]; v.x = left + m_size; v.y = m_size; layout.push_back( v );
+    v.s = glyph[0]; v.t = glyph[3]; v.x = left;          v.y = m_size; layout.push_back( v );
+    left += m_width;
+  }
+  return layout;
 }
@@ -8,6 +8,8 @@
 
 #include "GlobalGL.h"
 #include <string>
+#include <vector>
+#include <map>
 
 /**
  * \class	TextureFont
@@ -15,6 +17,11 @@
  *
  * Texture fonts are fonts based on an image. The image is used as a texture that is mapped
  * on rectangles to display the font.
+ *
+ * The characters of all texts are collected as quads in one vertex array. Each text is
+ * drawn with a single call, or, if several texts are printed between begin() and flush(),
+ * all of them are drawn together with one call. The quads of a text are laid out only
+ * once and reused as long as the same text is printed.
  * \author	Jan-Philipp Kappmeier
  * \date	27/09/2012
  */
@@ -27,13 +34,27 @@ public:
   unsigned int getWidth( void );
   void print( int x, int y, const char *string, ... );
   void print( int x, int y, const std::string *text );
+  void begin( void );
+  void flush( void );
   GLvoid killFont( GLvoid );
 private:
-  GLuint base;
+  //! A corner of a character quad, in the layout of GL_T2F_C4UB_V3F.
+  struct Vertex {
+    GLfloat s, t;
+    GLubyte color[4];
+    GLfloat x, y, z;
+  };
+  typedef std::vector<Vertex> Layout;
+
+  void add( int x, int y, const std::string &text );
+  const Layout & getLayout( const std::string &text );
+
   GLuint texture;
   GLuint count;
-  GLuint width;
-  GLuint height;
   unsigned int m_size;
   unsigned int m_width;
+  std::vector<GLfloat> glyphs;              // texture coordinates left, bottom, right, top of each character
+  std::map<std::string, Layout> layouts;    // the quads of printed texts, starting at the origin
+  Layout batch;                             // the quads that are drawn by the next flush()
+  bool batching;
 };
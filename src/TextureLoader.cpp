@@ -30,6 +30,15 @@ TextureLoader::~TextureLoader( void ) {
   }
 }
 
+/**
+ * \brief Returns false, as the image has to be mipmapped when the texture is created.
+ *
+ * Loaders that provide precomputed mipmap levels return true.
+ */
+bool TextureLoader::hasMipmaps( void ) {
+  return false;
+}
+
 /**
 /* \brief Load an image from memory.
  *
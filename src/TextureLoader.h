@@ -26,9 +26,10 @@
 class TextureLoader {
 public:
   TextureLoader( void );
-  ~TextureLoader( void );
+  virtual ~TextureLoader( void );
   virtual bool load( const std::string& filename ) = 0;
   virtual bool write( const std::string& filename ) = 0;
+  virtual bool hasMipmaps( void );
   bool load( BYTE *data, unsigned int width, unsigned int height, unsigned int bpp);
   unsigned int getWidth( void );
   unsigned int getHeight( void );
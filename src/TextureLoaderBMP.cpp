@@ -68,7 +68,7 @@ bool TextureLoaderBMP::load( const string& filename ) {
   } else { // unsupported file type
     return false;
   }
-  return false;
+  return true;
 }
 
 #define DIB_HEADER_MARKER ((WORD) ('M' << 8) | 'B')
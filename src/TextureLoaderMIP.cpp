@@ -0,0 +1,265 @@
+/**
+ * Copyright Jan-Philipp Kappmeier, Melanie Schmidt
+ * \file	TextureLoaderMIP.cpp
+ * \brief	The implementation of the TextureLoaderMIP class.
+ */
+#include "TextureLoaderMIP.h"
+#include "MappedFile.h"
+#include <string.h>
+
+using namespace std;
+
+// the version of the container files, has to be increased if the layout changes
+static const unsigned int containerVersion = 2;
+static const char containerMagic[4] = { 'M', 'M', 'I', 'P' };
+
+/**
+ * \brief Default constructor, the container belongs to no image.
+ */
+TextureLoaderMIP::TextureLoaderMIP( void ) {
+  sourceSize = 0;
+  sourceTime = 0;
+}
+
+/**
+ * \brief Default destructor, does nothing. The image data is freed by the base class.
+ */
+TextureLoaderMIP::~TextureLoaderMIP( void ) { }
+
+//! Loads a texture container.
+/**
+ * \fn bool TextureLoaderMIP::load( const std::string& filename )
+ * The file is mapped into memory and checked, then all levels are copied at once into
+ * the image data. No conversion or filtering takes place.
+ * \param filename the container file
+ * \return true if the file is a valid container
+ */
+bool TextureLoaderMIP::load( const string& filename ) {
+  MappedFile file;
+  if( !file.open( filename ) || file.getSize() < sizeof( Header ) )
+    return false;
+  const Header *header = (const Header *)file.getData();
+  if( memcmp( header->magic, containerMagic, 4 ) != 0 || header->version != containerVersion || header->levelCount == 0 )
+    return false;
+  size_t tableSize = header->levelCount * sizeof( Level );
+  if( file.getSize() != sizeof( Header ) + tableSize + header->dataSize )
+    return false;
+
+  sourceSize = header->sourceSize;
+  sourceTime = header->sourceTime;
+  const Level *table = (const Level *)(file.getData() + sizeof( Header ));
+  levels.assign( table, table + header->levelCount );
+  for( unsigned int i = 0; i < levels.size(); i++ )
+    if( levels[i].offset + levels[i].width * levels[i].height * header->channels > header->dataSize )
+      return false;
+
+  BYTE *image = new BYTE[header->dataSize];
+  memcpy( image, file.getData() + sizeof( Header ) + tableSize, header->dataSize );
+  setImage( image );
+  setWidth( levels[0].width );
+  setHeight( levels[0].height );
+  setBPP( header->channels );
+  setFormat( header->format );
+  return true;
+}
+
+//! Loads the texture container of an image, if it is up to date.
+/**
+ * \fn bool TextureLoaderMIP::loadFor( const std::string& sourceFile )
+ * The container is only used if the image has the size and the time of the last
+ * change that are stored in the container.
+ * \param sourceFile the image, the name of the container is given by getContainerFile()
+ * \return true if the container exists, is valid and belongs to the current image
+ */
+bool TextureLoaderMIP::loadFor( const string& sourceFile ) {
+  unsigned long long size, time;
+  if( !getSourceStamp( sourceFile, size, time ) || !load( getContainerFile( sourceFile ) ) )
+    return false;
+  return size == sourceSize && time == sourceTime;
+}
+
+//! Writes the levels into a texture container.
+/**
+ * \fn bool TextureLoaderMIP::write( const std::string& filename )
+ * \param filename the container file, is overwritten
+ * \return true if the file was written completely
+ */
+bool TextureLoaderMIP::write( const string& filename ) {
+  if( levels.empty() )
+    return false;
+  FILE *file = 0;
+  fopen_s( &file, filename.c_str(), "wb" );
+  if( !file )
+    return false;
+
+  Header header;
+  memcpy( header.magic, containerMagic, 4 );
+  header.version = containerVersion;
+  header.format = getFormat();
+  header.channels = getChannels();
+  header.levelCount = (unsigned int)levels.size();
+  const Level &last = levels.back();
+  header.dataSize = last.offset + last.width * last.height * header.channels;
+  header.sourceSize = sourceSize;
+  header.sourceTime = sourceTime;
+
+  bool written = fwrite( &header, sizeof( Header ), 1, file ) == 1;
+  written = written && fwrite( &levels[0], sizeof( Level ), levels.size(), file ) == levels.size();
+  written = written && fwrite( getImage(), header.dataSize, 1, file ) == 1;
+  fclose( file );
+  return written;
+}
+
+//! Computes the mipmap chain for an image.
+/**
+ * The image is scaled to the nearest powers of two, then the levels are created by
+ * halving the sides. The format and the color order of the source are kept.
+ * \param source a loader containing the image, e. g. a TextureLoaderBMP
+ * \param sourceFile the file of the image, its size and time are stored in the container
+ * \return false, if the source contains no image or the file does not exist
+ */
+bool TextureLoaderMIP::build( TextureLoader &source, const string& sourceFile ) {
+  if( source.getImage() == 0 || source.getWidth() == 0 || source.getHeight() == 0 )
+    return false;
+  if( !getSourceStamp( sourceFile, sourceSize, sourceTime ) )
+    return false;
+  setFormat( source.getFormat() );
+  const unsigned int channels = getChannels();
+
+  // compute the sizes of all levels
+  levels.clear();
+  Level level;
+  level.width = nearestPower( source.getWidth() );
+  level.height = nearestPower( source.getHeight() );
+  level.offset = 0;
+  while( true ) {
+    levels.push_back( level );
+    if( level.width == 1 && level.height == 1 )
+      break;
+    level.offset += level.width * level.height * channels;
+    level.width = level.width > 1 ? level.width / 2 : 1;
+    level.height = level.height > 1 ? level.height / 2 : 1;
+  }
+  const Level &last = levels.back();
+  BYTE *image = new BYTE[last.offset + last.width * last.height * channels];
+
+  // the rows of the source are aligned to four bytes, as assumed by the default unpack
+  // alignment that gluBuild2DMipmaps used
+  unsigned int sourceRow = (source.getWidth() * channels + 3) / 4 * 4;
+  BYTE *packed = new BYTE[source.getWidth() * source.getHeight() * channels];
+  for( unsigned int y = 0; y < source.getHeight(); y++ )
+    memcpy( packed + y * source.getWidth() * channels, source.getImage() + y * sourceRow, source.getWidth() * channels );
+  scale( packed, source.getWidth(), source.getHeight(), image, levels[0].width, levels[0].height, channels );
+  delete [] packed;
+
+  for( unsigned int i = 1; i < levels.size(); i++ )
+    scale( image + levels[i-1].offset, levels[i-1].width, levels[i-1].height,
+           image + levels[i].offset, levels[i].width, levels[i].height, channels );
+
+  setImage( image );
+  setWidth( levels[0].width );
+  setHeight( levels[0].height );
+  setBPP( channels );
+  return true;
+}
+
+/**
+ * \brief Returns true, as the container provides all mipmap levels.
+ */
+bool TextureLoaderMIP::hasMipmaps( void ) {
+  return true;
+}
+
+/**
+ * \brief Returns the number of mipmap levels, including the base level.
+ */
+unsigned int TextureLoaderMIP::getLevelCount( void ) {
+  return (unsigned int)levels.size();
+}
+
+/**
+ * \brief Returns the width of a mipmap level.
+ */
+unsigned int TextureLoaderMIP::getLevelWidth( unsigned int level ) {
+  return levels[level].width;
+}
+
+/**
+ * \brief Returns the height of a mipmap level.
+ */
+unsigned int TextureLoaderMIP::getLevelHeight( unsigned int level ) {
+  return levels[level].height;
+}
+
+/**
+ * \brief Returns the tightly packed image data of a mipmap level.
+ */
+BYTE *TextureLoaderMIP::getLevel( unsigned int level ) {
+  return getImage() + levels[level].offset;
+}
+
+/**
+ * \brief Returns the name of the container file that belongs to an image file. The ending is replaced by mip.
+ */
+string TextureLoaderMIP::getContainerFile( const string &filename ) {
+  size_t dot = filename.find_last_of( '.' );
+  if( dot == string::npos || filename.find_first_of( "/\\", dot ) != string::npos )
+    return filename + ".mip";
+  return filename.substr( 0, dot ) + ".mip";
+}
+
+/**
+ * \brief Gets the size of a file and the time of its last change, false if the file does not exist.
+ */
+bool TextureLoaderMIP::getSourceStamp( const string &filename, unsigned long long &size, unsigned long long &time ) {
+  WIN32_FILE_ATTRIBUTE_DATA data;
+  if( !GetFileAttributesExA( filename.c_str(), GetFileExInfoStandard, &data ) )
+    return false;
+  size = ((unsigned long long)data.nFileSizeHigh << 32) | data.nFileSizeLow;
+  time = ((unsigned long long)data.ftLastWriteTime.dwHighDateTime << 32) | data.ftLastWriteTime.dwLowDateTime;
+  return true;
+}
+
+/**
+ * \brief Returns the power of two that is nearest to a value, the same rounding as used by gluBuild2DMipmaps.
+ */
+unsigned int TextureLoaderMIP::nearestPower( unsigned int value ) {
+  unsigned int power = 1;
+  while( power * 2 <= value )
+    power *= 2;
+  if( value - power >= power * 2 - value )
+    power *= 2;
+  return power;
+}
+
+//! Scales an image using a box filter.
+/**
+ * Each pixel of the destination is the average of the source pixels covered by it. If
+ * the image is enlarged, the nearest source pixel is used.
+ */
+void TextureLoaderMIP::scale( const BYTE *source, unsigned int sourceWidth, unsigned int sourceHeight, BYTE *destination,
+                              unsigned int width, unsigned int height, unsigned int channels ) {
+  for( unsigned int y = 0; y < height; y++ ) {
+    unsigned int y0 = y * sourceHeight / height;
+    unsigned int y1 = max( y0 + 1, (y + 1) * sourceHeight / height );
+    for( unsigned int x = 0; x < width; x++ ) {
+      unsigned int x0 = x * sourceWidth / width;
+      unsigned int x1 = max( x0 + 1, (x + 1) * sourceWidth / width );
+      for( unsigned int c = 0; c < channels; c++ ) {
+        unsigned int sum = 0;
+        for( unsigned int sy = y0; sy < y1; sy++ )
+          for( unsigned int sx = x0; sx < x1; sx++ )
+            sum += source[(sy * sourceWidth + sx) * channels + c];
+        unsigned int count = (y1 - y0) * (x1 - x0);
+        destination[(y * width + x) * channels + c] = (BYTE)((sum + count / 2) / count);
+      }
+    }
+  }
+}
+
+/**
+ * \brief Returns the number of bytes per pixel for the format, four if it has an alpha channel.
+ */
+unsigned int TextureLoaderMIP::getChannels( void ) {
+  return getFormat() == GL_RGBA ? 4 : 3;
+}
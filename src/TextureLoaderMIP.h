@@ -0,0 +1,73 @@
+/**
+ * Copyright Jan-Philipp Kappmeier, Melanie Schmidt
+ * \file	TextureLoaderMIP.h
+ * \brief	Declares the TextureLoaderMIP, a loader for texture containers holding a complete mipmap chain.
+ */
+#pragma once
+
+#include "TextureLoader.h"
+#include <string>
+#include <vector>
+
+//! An implementation of the TextureLoader that loads textures with precomputed mipmaps.
+/**
+ * A container file stores all mipmap levels of a texture in the layout in which they
+ * are uploaded: the rows are tightly packed and the color order is the one of the
+ * format. The levels are computed once by build() from an image loaded by another
+ * loader, and stored with write(). This is done by the texture baker at build time, so
+ * at runtime the file is only copied into memory and each level is uploaded with
+ * glTexImage2D.
+ *
+ * The container stores the size and the time of the last change of the image it was
+ * built from. loadFor() rejects a container if the image has changed since, so an
+ * outdated container is not used until the baker is run again.
+ *
+ * The first level is the image of the base class, its size is scaled to powers of two
+ * as done by gluBuild2DMipmaps. Each further level halves both sides using a box filter,
+ * until both sides are one.
+ */
+class TextureLoaderMIP :
+  public TextureLoader {
+public:
+  TextureLoaderMIP( void );
+  ~TextureLoaderMIP( void );
+  bool load( const std::string& filename );
+  bool loadFor( const std::string& sourceFile );
+  bool write( const std::string& filename );
+  bool build( TextureLoader &source, const std::string& sourceFile );
+  bool hasMipmaps( void );
+
+  unsigned int getLevelCount( void );
+  unsigned int getLevelWidth( unsigned int level );
+  unsigned int getLevelHeight( unsigned int level );
+  BYTE *getLevel( unsigned int level );
+
+  static std::string getContainerFile( const std::string &filename );
+private:
+  static bool getSourceStamp( const std::string &filename, unsigned long long &size, unsigned long long &time );
+  static unsigned int nearestPower( unsigned int value );
+  static void scale( const BYTE *source, unsigned int sourceWidth, unsigned int sourceHeight, BYTE *destination,
+                     unsigned int width, unsigned int height, unsigned int channels );
+  unsigned int getChannels( void );
+
+  //! Size and position of one level in the image data.
+  struct Level {
+    unsigned int width;
+    unsigned int height;
+    unsigned int offset;
+  };
+  //! The header of a container, followed by the level table and the image data.
+  struct Header {
+    char magic[4];
+    unsigned int version;
+    unsigned int format;
+    unsigned int channels;
+    unsigned int levelCount;
+    unsigned int dataSize;
+    unsigned long long sourceSize;    // the size of the image the container was built from
+    unsigned long long sourceTime;    // the time of the last change of that image
+  };
+  std::vector<Level> levels;
+  unsigned long long sourceSize;
+  unsigned long long sourceTime;
+};
@@ -0,0 +1,120 @@
+/**
+ * Copyright Jan-Philipp Kappmeier, Melanie Schmidt
+ * \file	TextureStreamer.cpp
+ * \brief	Implementation of the background texture decoder.
+ */
+#include "TextureStreamer.h"
+#include "TextureLoader.h"
+#include "Textures.h"
+
+using namespace std;
+
+//! Starts the worker thread.
+TextureStreamer::TextureStreamer( void ) {
+  terminate = false;
+  InitializeCriticalSection( &lock );
+  wakeUp = CreateEvent( NULL, FALSE, FALSE, NULL );
+  thread = CreateThread( NULL, 0, run, this, 0, NULL );
+}
+
+//! Stops the worker thread and frees all images that have not been fetched.
+/**
+ * The worker finishes the image it is currently decoding before it stops.
+ */
+TextureStreamer::~TextureStreamer( void ) {
+  EnterCriticalSection( &lock );
+  terminate = true;
+  LeaveCriticalSection( &lock );
+  SetEvent( wakeUp );
+  WaitForSingleObject( thread, INFINITE );
+  CloseHandle( thread );
+  CloseHandle( wakeUp );
+  DeleteCriticalSection( &lock );
+  for( unsigned int i = 0; i < decoded.size(); i++ )
+    delete decoded[i].second;
+}
+
+//! Adds a file to the list of files that are decoded.
+/**
+ * If the file has already been requested and is not fetched yet, nothing happens.
+ * \param filename the texture file
+ */
+void TextureStreamer::request( const string &filename ) {
+  EnterCriticalSection( &lock );
+  if( pending.insert( filename ).second )
+    requests.push_back( filename );
+  LeaveCriticalSection( &lock );
+  SetEvent( wakeUp );
+}
+
+//! Returns the next decoded image.
+/**
+ * The caller takes the ownership of the returned loader. Files that could not be
+ * loaded are skipped.
+ * \param filename is set to the file the image was loaded from
+ * \return the loader containing the image, or 0 if no image is finished
+ */
+TextureLoader * TextureStreamer::getDecoded( string &filename ) {
+  TextureLoader *loader = 0;
+  EnterCriticalSection( &lock );
+  if( !decoded.empty() ) {
+    filename = decoded.front().first;
+    loader = decoded.front().second;
+    decoded.pop_front();
+    pending.erase( filename );
+  }
+  LeaveCriticalSection( &lock );
+  return loader;
+}
+
+/**
+ * \brief Checks whether a file is requested but has not been fetched yet.
+ * \param filename the texture file
+ */
+bool TextureStreamer::isPending( const string &filename ) {
+  EnterCriticalSection( &lock );
+  bool result = pending.find( filename ) != pending.end();
+  LeaveCriticalSection( &lock );
+  return result;
+}
+
+/**
+ * \brief The entry point of the worker thread.
+ * \param parameter the streamer that started the thread
+ */
+DWORD WINAPI TextureStreamer::run( LPVOID parameter ) {
+  static_cast<TextureStreamer*>( parameter )->work();
+  return 0;
+}
+
+//! The loop of the worker thread.
+/**
+ * Decodes the requested files one after another. The lock is released while a file
+ * is decoded, so the render thread is never blocked by the file access.
+ */
+void TextureStreamer::work( void ) {
+  while( true ) {
+    EnterCriticalSection( &lock );
+    if( terminate ) {
+      LeaveCriticalSection( &lock );
+      return;
+    }
+    if( requests.empty() ) {
+      LeaveCriticalSection( &lock );
+      WaitForSingleObject( wakeUp, INFINITE );
+      continue;
+    }
+    string filename = requests.front();
+    requests.pop_front();
+    LeaveCriticalSection( &lock );
+
+    TextureLoader *loader = Textures::decodeTexture( filename );
+
+    EnterCriticalSection( &lock );
+    if( loader )
+      decoded.push_back( make_pair( filename, loader ) );
+    else
+      pending.erase( filename );
+    LeaveCriticalSection( &lock );
+  }
+}
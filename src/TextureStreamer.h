@@ -0,0 +1,41 @@
+/**
+ * Copyright Jan-Philipp Kappmeier, Melanie Schmidt
+ * \file	TextureStreamer.h
+ * \brief	Declares a background thread that decodes texture files.
+ */
+#pragma once
+
+#include "GlobalGL.h"
+#include <string>
+#include <deque>
+#include <set>
+
+class TextureLoader;
+
+//! Decodes texture files in a background thread.
+/**
+ * Requested files are loaded into memory by a worker thread using the TextureLoader
+ * classes. The decoded images are collected until they are fetched by the thread that
+ * owns the OpenGL context, which has to create the textures. All lists are protected
+ * by a critical section, the worker sleeps on an event while there are no requests.
+ */
+class TextureStreamer {
+public:
+  TextureStreamer( void );
+  ~TextureStreamer( void );
+
+  void request( const std::string &filename );
+  TextureLoader * getDecoded( std::string &filename );
+  bool isPending( const std::string &filename );
+private:
+  static DWORD WINAPI run( LPVOID parameter );
+  void work( void );
+
+  HANDLE thread;
+  HANDLE wakeUp;
+  CRITICAL_SECTION lock;
+  bool terminate;
+  std::deque<std::string> requests;                              // files waiting for the worker
+  std::deque<std::pair<std::string, TextureLoader*> > decoded;   // images waiting for the upload
+  std::set<std::string> pending;                                 // all files in one of the two lists or in work
+};
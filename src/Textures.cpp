@@ -6,6 +6,8 @@
 #include "Textures.h"
 #include "TextureLoaderBMP.h"
 #include "TextureLoaderTGA.h"
+#include "TextureLoaderMIP.h"
+#include "TextureStreamer.h"
 #include "LittleHelper.h"
 
 using namespace std;
@@ -37,22 +39,27 @@ Textures *Textures::getTextures( void ) {
 //! Standard constructor.
 /**
  * Initializes space for ten textures and disables BGR to RGB conversion if files with BGR format
- * are loaded.
+ * are loaded. The streamer starts its background thread.
  */
 Textures::Textures( void ) {
   reserve( 10 );
   switchRGB2BGR = false;
+  streamer = new TextureStreamer();
 }
 
 //! Destructor
 /**
  * Trys to free all textures with freeTextures() and after that clears the vector holding
- * the generated texture numbers.
+ * the generated texture numbers. At last the cached textures are deleted.
  */
 Textures::~Textures( void ) {
+  delete streamer;
   for( unsigned int i=0; i < textures.size(); i++ )
     freeTexture( i );
   textures.clear();
+  cached.clear();
+  clearCache();
+  m_textures = 0;
 }
 //@}
 
@@ -66,11 +73,19 @@ Textures::~Textures( void ) {
 //! Set's conversion between RGB and BGR on and off.
 /**
  * If 'true' is submitted, the red and blue components of a loaded texture are
- * changed. This could be used to create textures which seem to be varied.
+ * changed. This could be used to create textures which seem to be varied. If the
+ * value changes, the cached textures are deleted as they have the old colors. The
+ * slots referencing them are freed and have to be loaded again.
  * \param value determines wheather conversion is active or not
  */
 void Textures::changeColors( bool value ) {
+  if( switchRGB2BGR == value )
+    return;
   switchRGB2BGR = value;
+  for( unsigned int i=0; i < textures.size(); i++ )
+    if( cached[i] )
+      freeTexture( i );
+  clearCache();
 }
 
 //! Frees texture memory.
@@ -85,19 +100,23 @@ void Textures::freeTexture ( unsigned int texture ) {
   if( textures[texture] == -1 )// try to free unassigned texture
     return;
 
-  // delete texture and information
-  GLuint id = (GLuint) textures[texture];
-  glDeleteTextures( 1, &id );
+  // delete texture and information. cached textures are only deleted with the cache
+  if( !cached[texture] ) {
+    GLuint id = (GLuint) textures[texture];
+    glDeleteTextures( 1, &id );
+  }
   textures[texture] = -1;
+  cached[texture] = false;
 }
 
 //! Loads a texture from a file into a texture slot.
 /**
  * \fn void Textures::loadTexture( unsigned int texture, std::string filename )
  * Loads a texture from a file. The texture is accessed by an texture value 
- * which is send by the application. After that a new texture name is generated
- * by OpenGL. If the texture value is already assigned to a texture, the old
- * texture is deleted and the OpenGL texture name is freed. 
+ * which is send by the application. If the texture value is already assigned
+ * to a texture, the old texture is freed. If the file is in the cache, the slot
+ * only references the cached texture, otherwise the file is loaded immediately
+ * and added to the cache.
  * \param filename the filename of the texture
  * \param texture the number of the texture, used for indexing the texture vector
  */
@@ -109,26 +128,85 @@ void Textures::loadTexture( unsigned int texture, std::string filename ) {
     freeTexture( texture );
   }
 
-  GLuint id;
-  glGenTextures ( 1, &id );
-  textures[texture] = (int) id;
+  map<string, GLuint>::iterator it = cache.find( filename );
+  if( it == cache.end() ) {
+    TextureLoader *texLoader = decodeTexture( filename );
+    if( texLoader == 0 )
+      return;
+    loadTexture( texture, filename, texLoader );
+    delete texLoader;
+    return;
+  }
+  textures[texture] = (int) it->second;
+  cached[texture] = true;
+}
 
-  // load new texture. currently, only bmp is usable. all files are identified by their ending
-  if( LittleHelper::stringCmpi( filename.substr(filename.length() - 3, 3), "bmp" ) == 0) {
-    //loadTextureBMP( texture, filename );
-    texLoader = new TextureLoaderBMP();
-    texLoader->load( filename );
+//! Loads an image that has already been decoded from a file into a texture slot.
+/**
+ * The texture is added to the cache under the filename. If the file is already
+ * in the cache, the image is not used and the slot references the cached texture.
+ * The caller keeps the ownership of the loader.
+ * \param texture the number of the texture, used for indexing the texture vector
+ * \param filename the file the image was decoded from
+ * \param loader the loader containing the image, see decodeTexture()
+ */
+void Textures::loadTexture( unsigned int texture, const std::string &filename, TextureLoader* loader ) {
+  if( texture >= textures.size() )
+    reserve( texture + 1 );
+
+  if( textures[texture] != -1 ) {
+    freeTexture( texture );
   }
-  if( LittleHelper::stringCmpi( filename.substr(filename.length() - 3, 3), "tga" ) == 0) {
-    //loadTextureTGA( texture, filename );
+
+  map<string, GLuint>::iterator it = cache.find( filename );
+  if( it == cache.end() )
+    it = cache.insert( make_pair( filename, createTexture( loader ) ) ).first;
+  textures[texture] = (int) it->second;
+  cached[texture] = true;
+}
+
+//! Loads an image file into memory.
+/**
+ * If a texture container with precomputed mipmaps exists for the file and the file has
+ * not changed since the container was built, the container is loaded instead, see
+ * TextureLoaderMIP. Otherwise a loader that fits to the ending of the file is created.
+ * Currently, only bmp and tga are usable. No OpenGL functions are called, so this can
+ * be done in any thread.
+ * \param filename the filename of the texture
+ * \return the loader containing the image or 0 if the file could not be loaded. The
+ * caller has to delete the loader.
+ */
+TextureLoader * Textures::decodeTexture( const std::string &filename ) {
+  TextureLoaderMIP *container = new TextureLoaderMIP();
+  if( container->loadFor( filename ) )
+    return container;
+  delete container;
+
+  TextureLoader *texLoader = 0;
+  if( LittleHelper::stringCmpi( filename.substr(filename.length() - 3, 3), "bmp" ) == 0)
+    texLoader = new TextureLoaderBMP();
+  if( LittleHelper::stringCmpi( filename.substr(filename.length() - 3, 3), "tga" ) == 0)
     texLoader = new TextureLoaderTGA();
-    texLoader->load( filename );
-    // try to write on harddisk
-    texLoader->write( "testoutput.tga");
+  if( texLoader == 0 )
+    return 0;
+  if( !texLoader->load( filename ) ) {
+    delete texLoader;
+    return 0;
   }
+  return texLoader;
+}
 
-  // now the texture should be loaded
-  bindTexture( texture );
+//! Creates a mipmapped OpenGL texture from an image in memory.
+/**
+ * If the loader provides precomputed mipmaps, each level is uploaded as it is. Otherwise
+ * the levels are created by gluBuild2DMipmaps.
+ * \param loader the loader containing the image
+ * \return the OpenGL texture name
+ */
+GLuint Textures::createTexture( TextureLoader *loader ) {
+  GLuint id;
+  glGenTextures ( 1, &id );
+  glBindTexture( GL_TEXTURE_2D, id );
 
   // possible qualities
   // GL_NEAREST
@@ -145,19 +223,26 @@ void Textures::loadTexture( unsigned int texture, std::string filename ) {
   GLenum usedFormat;
 #ifdef GL_BGR_EXT
   if( switchRGB2BGR )
-    if( texLoader->isBGR() )
+    if( loader->isBGR() )
       usedFormat = GL_RGB;
     else
       usedFormat = GL_BGR_EXT;
   else
-    usedFormat = texLoader->getFormat();
+    usedFormat = loader->getFormat();
 #else
   usedFormat = GL_RGB;
 #endif
 
-  gluBuild2DMipmaps(GL_TEXTURE_2D, 3, texLoader->getWidth(), texLoader->getHeight(), usedFormat, GL_UNSIGNED_BYTE, texLoader->getImage() );
-  // glTexImage2D(GL_TEXTURE_2D, 0, 3, TextureImage[0]->sizeX, TextureImage[0]->sizeY, 0, GL_RGB, GL_UNSIGNED_BYTE, TextureImage[0]->data);
-  delete texLoader;
+  if( loader->hasMipmaps() ) {
+    // the levels of a container are tightly packed
+    TextureLoaderMIP *container = static_cast<TextureLoaderMIP*>( loader );
+    glPixelStorei( GL_UNPACK_ALIGNMENT, 1 );
+    for( unsigned int i=0; i < container->getLevelCount(); i++ )
+      glTexImage2D( GL_TEXTURE_2D, i, 3, container->getLevelWidth( i ), container->getLevelHeight( i ), 0, usedFormat, GL_UNSIGNED_BYTE, container->getLevel( i ) );
+    glPixelStorei( GL_UNPACK_ALIGNMENT, 4 );
+  } else
+    gluBuild2DMipmaps(GL_TEXTURE_2D, 3, loader->getWidth(), loader->getHeight(), usedFormat, GL_UNSIGNED_BYTE, loader->getImage() );
+  return id;
 }
 
 //! Loads a texture from memory into a texture slot.
@@ -178,6 +263,7 @@ void Textures::loadTexture( unsigned int texture, TextureLoader* loader ) {
   GLuint id;
   glGenTextures ( 1, &id );
   textures[texture] = (int) id;
+  cached[texture] = false;
 
   // now the texture should be loaded
   bindTexture( texture );
@@ -226,6 +312,7 @@ void Textures::reserve( unsigned int textureCount ) {
 
   textures.reserve( textureCount );
   textures.resize ( textureCount );
+  cached.resize( textureCount, false );
 
   // initialize new texture space
   for( size_t i=oldSize; i < textures.size(); i++ )
@@ -233,6 +320,58 @@ void Textures::reserve( unsigned int textureCount ) {
 }
 //@}
 
+/** @name Streaming
+ * These functions allow to load textures in the background before they are needed. A prefetched file
+ * is decoded by the TextureStreamer thread, the OpenGL textures are created in Textures::update(),
+ * which has to be called in the thread owning the OpenGL context.
+ */
+//@{
+/**
+ * \brief Checks whether a file is loaded into the cache, so loading it into a slot is free.
+ * \param filename the filename of the texture
+ */
+bool Textures::isCached( const std::string &filename ) {
+  return cache.find( filename ) != cache.end();
+}
+
+//! Requests a file to be loaded in the background.
+/**
+ * Files that are already in the cache are ignored.
+ * \param filename the filename of the texture
+ */
+void Textures::prefetchTexture( const std::string &filename ) {
+  if( !isCached( filename ) )
+    streamer->request( filename );
+}
+
+//! Creates textures for the decoded images.
+/**
+ * Creating the mipmaps takes some time, so only a limited number of textures is created in
+ * each call. Images of files that have been loaded directly in the meantime are dropped.
+ * \param uploadBudget the maximal number of textures that are created
+ */
+void Textures::update( unsigned int uploadBudget ) {
+  for( unsigned int i=0; i < uploadBudget; i++ ) {
+    string filename;
+    TextureLoader *loader = streamer->getDecoded( filename );
+    if( loader == 0 )
+      return;
+    if( !isCached( filename ) )
+      cache[filename] = createTexture( loader );
+    delete loader;
+  }
+}
+
+/**
+ * \brief Deletes all cached textures. The slots referencing them have to be freed before.
+ */
+void Textures::clearCache( void ) {
+  for( map<string, GLuint>::iterator it = cache.begin(); it != cache.end(); it++ )
+    glDeleteTextures( 1, &it->second );
+  cache.clear();
+}
+//@}
+
 /** @name Additional functionalities
  * These functions provide some additional functionalities. The Textures::bindTexture() function allows it
  * easyly to bind a loaded texture as GL_TEXTURE_2D.
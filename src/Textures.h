@@ -5,9 +5,13 @@
  */
 #pragma once
 
+#include "GlobalGL.h"
 #include <vector>
+#include <map>
+#include <string>
 
 class TextureLoader;
+class TextureStreamer;
 
 //! Implements a texture manager that loads files and sets up OpenGL textures.
 /**
@@ -23,6 +27,10 @@ class TextureLoader;
  * Also this class gives the ability to change the way how the textures should be created such as defining
  * the quality and the color type. It can also be defined if some or all types of EXT texture types
  * are allowed or forbidden.
+ *
+ * Textures loaded from files are cached by their filename, a slot only references the cached texture.
+ * Files can be prefetched, they are decoded by a TextureStreamer in the background and uploaded in
+ * update(). Loading a cached file into a slot costs nothing.
  */
 class Textures {
 public:
@@ -36,12 +44,26 @@ public:
   void changeColors( bool value );
   void loadTexture( unsigned int texture, std::string filename );
   void loadTexture( unsigned int texture, TextureLoader* loader );
+  void loadTexture( unsigned int texture, const std::string &filename, TextureLoader* loader );
   void reserve( unsigned int count );
   void freeTexture ( unsigned int texture );
+  static TextureLoader * decodeTexture( const std::string &filename );
+
+  // streaming
+public:
+  bool isCached( const std::string &filename );
+  void prefetchTexture( const std::string &filename );
+  void update( unsigned int uploadBudget );
+private:
+  GLuint createTexture( TextureLoader *loader );
+  void clearCache( void );
+
 private:
   bool switchRGB2BGR;         //!< Status variable that indicates wheather red and blue components in image data are interchanged
   std::vector<int> textures;  //!< Vector that holds the OpenGL created texture names, -1 for no texture
-  TextureLoader *texLoader;   //!< Abstract class that is used to load an texture file into memory
+  std::vector<bool> cached;   //!< True for slots that reference a texture in the cache, these are not deleted with the slot
+  std::map<std::string, GLuint> cache;  //!< The textures loaded from files, indexed by filename
+  TextureStreamer *streamer;  //!< Decodes prefetched files in the background
 
 public:
   void bindTexture( unsigned int texture ); // this texture is _not_ the OpenGL texture name but an application dependent!
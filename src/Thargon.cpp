@@ -5,7 +5,7 @@
  */
 #include "Thargon.h"
 
-Thargon::Thargon(float r, GLuint displayList, PlayerObject *player, float maxSpeed):ForeignSpaceShip(r,displayList)
+Thargon::Thargon(float r, Mesh *mesh, PlayerObject *player, float maxSpeed):ForeignSpaceShip(r,mesh)
 { 
   this->player = player;
   this->setShoot(false);
@@ -19,23 +19,20 @@ Thargon::~Thargon(void)
 
 void Thargon::adjust( float t )
 {
-  Vector3 playerPos = player->getPos();
-  Vector3 myPos = this->getPos();
-  Vector3 desiredView = playerPos - myPos;
-
-  float distance = desiredView.length();
+  Vector3 desiredView = m_playerOffset;
+  float distance = m_playerDistance;
 
   if (distance < 100)
-	  setSpeed(maxSpeed);
+	  steerSpeed(maxSpeed);
   else
   {
 	  if (this->shipWasHitOnce())
-		  setSpeed(10*maxSpeed);
+		  steerSpeed(10*maxSpeed);
 	  else
-		  setSpeed(0);
+		  steerSpeed(0);
   }
 
   desiredView.normalize();
 
-  this->setView(desiredView);
+  steerView(desiredView);
 }
\ No newline at end of file
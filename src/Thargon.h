@@ -12,7 +12,7 @@ class Thargon :
 	public ForeignSpaceShip
 {
 public:
-	Thargon(float r, GLuint displayList, PlayerObject *player, float maxSpeed);
+	Thargon(float r, Mesh *mesh, PlayerObject *player, float maxSpeed);
 public:
 	~Thargon(void);
 public:
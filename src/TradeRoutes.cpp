@@ -0,0 +1,379 @@
+/**
+ * Copyright Jan-Philipp Kappmeier, Melanie Schmidt
+ * \file	TradeRoutes.cpp
+ * \brief	The implementation of the TradeRoutes class.
+ */
+#include "TradeRoutes.h"
+#include "JobPool.h"
+#include <algorithm>
+#include <climits>
+#include <math.h>
+
+using namespace std;
+
+// the number of jumps from which on find() searches in parallel, shorter routes are found faster by one thread
+static const unsigned int PARALLEL_HOPS = 3;
+
+/**
+ * \brief Initializes empty tables, all goods are in tons.
+ */
+TradeRoutes::TradeRoutes( void ) {
+  distances = 0;
+  neighbours = 0;
+  maxFuel = 0;
+  fuelCost = 0;
+  for( unsigned int i = 0; i < goodCount; i++ )
+    inTons[i] = true;
+  pool = 0;
+  rankSteps[0] = 0;
+  for( unsigned int r = 1; r < rankStepCount; r++ )
+    rankSteps[r] = (long long)pow( 2.0, (r - 1) / 2.0 );
+}
+
+/**
+ * \brief Destructor, does nothing. The job pool belongs to its creator.
+ */
+TradeRoutes::~TradeRoutes( void ) { }
+
+/**
+ * \brief Sets the job pool that runs the searches in parallel, they run in the calling thread if it is 0. The pool is not deleted.
+ */
+void TradeRoutes::setJobPool( JobPool *pool ) {
+  this->pool = pool;
+}
+
+//! Sets the tables of the galaxy.
+/**
+ * The tables are owned by the game and are not copied, they have to be valid as long as
+ * routes are searched.
+ * \param distances the distances between all systems in tenths of light years
+ * \param neighbours for each system all systems within the range of a full tank
+ */
+void TradeRoutes::setGalaxy( const unsigned short (*distances)[systemCount], const vector<int> *neighbours ) {
+  this->distances = distances;
+  this->neighbours = neighbours;
+}
+
+/**
+ * \brief Sets the size of the tank in tenths of light years and the price of fuel in tenths of credits.
+ */
+void TradeRoutes::setFuel( unsigned int maxFuel, unsigned int fuelCost ) {
+  this->maxFuel = maxFuel;
+  this->fuelCost = fuelCost;
+}
+
+/**
+ * \brief Sets whether a good is measured in tons. Only these goods need space in the cargo bay.
+ */
+void TradeRoutes::setInTons( unsigned int good, bool inTons ) {
+  this->inTons[good] = inTons;
+}
+
+/**
+ * \brief Sets the expected market of a system.
+ */
+void TradeRoutes::setMarket( unsigned int system, const Market &market ) {
+  markets[system] = market;
+}
+
+//! Finds the best routes starting at a system.
+/**
+ * \param start the start system
+ * \param startMarket the market of the start system
+ * \param cash the cash in tenths of credits
+ * \param holdspace the free space in the cargo bay in tons
+ * \param hops the maximal number of jumps, at most maxHops
+ * \param count the maximal number of routes returned
+ * \param perFuel ranks by the profit per light year if true, otherwise by the profit
+ * \return the routes with a profit, the best first. Has to be deleted by the caller.
+ */
+vector<TradeRoute> * TradeRoutes::find( unsigned int start, const Market &startMarket, long cash, unsigned int holdspace,
+                                        unsigned int hops, unsigned int count, bool perFuel ) {
+  hops = min( hops, maxHops );
+  Jobs jobs;
+  jobs.routes = this;
+  jobs.startMarket = &startMarket;
+  jobs.cash = cash;
+  for( unsigned int i = 0; i < neighbours[start].size(); i++ )
+    if( neighbours[start][i] != (int)start )
+      jobs.first.push_back( neighbours[start][i] );
+  jobs.searches.resize( jobs.first.size() );
+  for( unsigned int i = 0; i < jobs.searches.size(); i++ ) {
+    init( jobs.searches[i], hops, count, perFuel, holdspace );
+    jobs.searches[i].systems[0] = start;
+  }
+  bound( holdspace, hops, perFuel );
+  if( hops >= PARALLEL_HOPS && pool != 0 )
+    pool->run( runFirst, &jobs, (unsigned int)jobs.first.size() );
+  else
+    for( unsigned int i = 0; i < jobs.first.size(); i++ )
+      runFirst( &jobs, i );
+  return merge( jobs.searches, count );
+}
+
+//! Finds the best route starting at each system of the galaxy.
+/**
+ * All systems start with their expected market. The searches are divided among the
+ * threads of the job pool.
+ * \param cash the cash in tenths of credits
+ * \param holdspace the free space in the cargo bay in tons
+ * \param hops the maximal number of jumps, at most maxHops
+ * \param perFuel ranks by the profit per light year if true, otherwise by the profit
+ * \return one route for each system, without jumps if there is no profitable route.
+ * Has to be deleted by the caller.
+ */
+vector<TradeRoute> * TradeRoutes::findFromAll( long cash, unsigned int holdspace, unsigned int hops, bool perFuel ) {
+  Jobs jobs;
+  jobs.routes = this;
+  jobs.startMarket = 0;
+  jobs.cash = cash;
+  jobs.searches.resize( systemCount );
+  for( unsigned int i = 0; i < systemCount; i++ ) {
+    init( jobs.searches[i], min( hops, maxHops ), 1, perFuel, holdspace );
+    jobs.searches[i].systems[0] = i;
+  }
+  bound( holdspace, min( hops, maxHops ), perFuel );
+  if( pool != 0 )
+    pool->run( runStart, &jobs, systemCount );
+  else
+    for( unsigned int i = 0; i < systemCount; i++ )
+      runStart( &jobs, i );
+
+  vector<TradeRoute> *result = new vector<TradeRoute>( systemCount );
+  for( unsigned int i = 0; i < systemCount; i++ )
+    if( !jobs.searches[i].best.empty() )
+      (*result)[i] = jobs.searches[i].best[0];
+  return result;
+}
+
+/**
+ * \brief A job of find(), searches the routes that start with one jump.
+ */
+void TradeRoutes::runFirst( void *context, unsigned int index ) {
+  Jobs *jobs = static_cast<Jobs*>( context );
+  jobs->routes->jump( jobs->searches[index], 0, *jobs->startMarket, jobs->first[index], jobs->cash, 0, 0 );
+}
+
+/**
+ * \brief A job of findFromAll(), searches the routes that start at one system.
+ */
+void TradeRoutes::runStart( void *context, unsigned int index ) {
+  Jobs *jobs = static_cast<Jobs*>( context );
+  TradeRoutes *routes = jobs->routes;
+  routes->extend( jobs->searches[index], 0, routes->markets[index], jobs->cash, 0, 0 );
+}
+
+/**
+ * \brief Sets the parameters of a search and removes the routes found before.
+ */
+void TradeRoutes::init( Search &search, unsigned int hops, unsigned int count, bool perFuel, unsigned int holdspace ) {
+  search.hops = hops;
+  search.count = count;
+  search.perFuel = perFuel;
+  search.holdspace = holdspace;
+  search.best.clear();
+  search.ranks.clear();
+}
+
+//! Computes the bounds used by extend() to skip routes that can not be among the best.
+/**
+ * The profit of each jump is estimated with unlimited cash. For each rank step r, the
+ * most that up to k further jumps from a system can add to 1000 times the profit minus
+ * r times the fuel is computed. If the routes are ranked by their profit, only the step
+ * 0 is needed, which bounds the profit of the further jumps.
+ * \param holdspace the free space in the cargo bay in tons
+ * \param hops the maximal number of jumps of the searched routes
+ * \param perFuel true if the routes are ranked by their profit per light year
+ */
+void TradeRoutes::bound( unsigned int holdspace, unsigned int hops, bool perFuel ) {
+  vector<long> profits; // of the jumps to the neighbours of all systems, in the order of the neighbours
+  for( unsigned int from = 0; from < systemCount; from++ )
+    for( unsigned int i = 0; i < neighbours[from].size(); i++ ) {
+      const unsigned int to = neighbours[from][i];
+      int good;
+      unsigned int amount;
+      if( to == from || distances[from][to] > maxFuel )
+        profits.push_back( LONG_MIN );
+      else
+        profits.push_back( choose( markets[from], markets[to], holdspace, LONG_MAX, good, amount ) - (long)(distances[from][to] * fuelCost) );
+    }
+
+  const unsigned int steps = perFuel ? rankStepCount : 1;
+  futureGain.assign( steps * (maxHops + 1) * systemCount, 0 );
+  for( unsigned int r = 0; r < steps; r++ ) {
+    long long *gain = &futureGain[r * (maxHops + 1) * systemCount];
+    for( unsigned int k = 1; k <= hops; k++ ) {
+      const long *profit = profits.empty() ? 0 : &profits[0];
+      for( unsigned int from = 0; from < systemCount; from++ ) {
+        long long best = 0; // the route may also end here
+        for( unsigned int i = 0; i < neighbours[from].size(); i++, profit++ )
+          if( *profit != LONG_MIN ) {
+            const unsigned int to = neighbours[from][i];
+            best = max( best, 1000LL * *profit - rankSteps[r] * distances[from][to] + gain[(k - 1) * systemCount + to] );
+          }
+        gain[k * systemCount + from] = best;
+      }
+    }
+  }
+}
+
+//! Tests whether an extension of the current route can be among the best routes of the search.
+/**
+ * An extension adds the profit A and the fuel D to the profit P and the fuel F of the
+ * current route. Ranked by the profit per light year, it is ranked above the worst
+ * rank w only if 1000 (P + A) >= (w + 1) (F + D), so 1000 A - r D >= (w + 1) F - 1000 P
+ * must hold for the largest rank step r <= w + 1. The left side is bounded by bound().
+ */
+bool TradeRoutes::canImprove( const Search &search, unsigned int depth, long profit, unsigned int fuel ) {
+  if( search.ranks.size() < search.count )
+    return true;
+  const unsigned int index = (search.hops - depth) * systemCount + search.systems[depth];
+  if( !search.perFuel )
+    return 1000LL * profit + futureGain[index] > 1000LL * search.ranks.back();
+  if( fuel == 0 )
+    return true;
+  const long long rank = search.ranks.back() + 1;
+  const unsigned int r = (unsigned int)(upper_bound( rankSteps, rankSteps + rankStepCount, rank ) - rankSteps) - 1;
+  return futureGain[r * (maxHops + 1) * systemCount + index] >= rank * fuel - 1000LL * profit;
+}
+
+/**
+ * \brief Tries all jumps from the last system of the current route, unless no extension can be among the best routes.
+ */
+void TradeRoutes::extend( Search &search, unsigned int depth, const Market &market, long cash, long profit, unsigned int fuel ) {
+  if( !canImprove( search, depth, profit, fuel ) )
+    return;
+  const vector<int> &next = neighbours[search.systems[depth]];
+  for( unsigned int i = 0; i < next.size(); i++ )
+    if( next[i] != (int)search.systems[depth] )
+      jump( search, depth, market, next[i], cash, profit, fuel );
+}
+
+//! Adds a jump to the current route.
+/**
+ * The good with the highest profit is bought at the market of the last system, if the
+ * fuel can be paid. Then the route is stored and extended further, if it has less than
+ * the maximal number of jumps.
+ * \param search the search
+ * \param depth the number of jumps of the current route
+ * \param market the market of the last system
+ * \param to the destination of the jump
+ * \param cash the cash at the last system in tenths of credits
+ * \param profit the profit of the current route in tenths of credits
+ * \param fuel the fuel needed for the current route in tenths of light years
+ */
+void TradeRoutes::jump( Search &search, unsigned int depth, const Market &market, unsigned int to, long cash, long profit, unsigned int fuel ) {
+  const unsigned int from = search.systems[depth];
+  const unsigned int distance = distances[from][to];
+  const long budget = cash - (long)(distance * fuelCost);
+  if( distance > maxFuel || budget < 0 )
+    return;
+
+  const Market &destination = markets[to];
+  int bestGood;
+  unsigned int bestAmount;
+  long bestGain = choose( market, destination, search.holdspace, budget, bestGood, bestAmount );
+
+  search.systems[depth + 1] = to;
+  search.goods[depth] = bestGood;
+  search.amounts[depth] = bestAmount;
+  search.profits[depth] = bestGain - (long)(distance * fuelCost);
+  profit += search.profits[depth];
+  fuel += distance;
+  store( search, depth + 1, profit, fuel );
+  if( depth + 1 < search.hops )
+    extend( search, depth + 1, destination, budget + bestGain, profit, fuel );
+}
+
+//! Chooses the good with the highest profit between two markets.
+/**
+ * \param market the market where the good is bought
+ * \param destination the market where the good is sold
+ * \param holdspace the free space in the cargo bay in tons
+ * \param budget the cash that can be spent in tenths of credits
+ * \param good the chosen good, -1 if no good gives a profit
+ * \param amount the amount of the chosen good
+ * \return the profit in tenths of credits
+ */
+long TradeRoutes::choose( const Market &market, const Market &destination, unsigned int holdspace, long budget,
+                          int &good, unsigned int &amount ) {
+  good = -1;
+  amount = 0;
+  long bestGain = 0;
+  for( unsigned int g = 0; g < goodCount; g++ ) {
+    if( destination.price[g] <= market.price[g] || market.quantity[g] == 0 )
+      continue;
+    unsigned int available = market.quantity[g];
+    if( inTons[g] )
+      available = min( available, holdspace );
+    if( market.price[g] > 0 )
+      available = (unsigned int)min( (long)available, budget / (long)market.price[g] );
+    long gain = (long)available * (long)(destination.price[g] - market.price[g]);
+    if( gain > bestGain ) {
+      good = g;
+      amount = available;
+      bestGain = gain;
+    }
+  }
+  return bestGain;
+}
+
+/**
+ * \brief Inserts the current route into the best routes of the search, if it has a profit and a high enough rank.
+ */
+void TradeRoutes::store( Search &search, unsigned int depth, long profit, unsigned int fuel ) {
+  if( profit <= 0 || search.count == 0 )
+    return;
+  long long rank = search.perFuel ? (long long)profit * 1000 / max( fuel, 1u ) : profit;
+  if( search.ranks.size() == search.count && rank <= search.ranks.back() )
+    return;
+
+  TradeRoute route;
+  route.profit = profit / 10.0f;
+  route.distance = fuel / 10.0f;
+  route.legs.resize( depth );
+  for( unsigned int i = 0; i < depth; i++ ) {
+    TradeLeg &leg = route.legs[i];
+    leg.from = search.systems[i];
+    leg.to = search.systems[i + 1];
+    leg.distance = distances[leg.from][leg.to] / 10.0f;
+    leg.good = search.goods[i];
+    leg.amount = search.amounts[i];
+    leg.profit = search.profits[i] / 10.0f;
+  }
+
+  // after the routes with the same rank, so the first one found stays in front
+  size_t position = upper_bound( search.ranks.begin(), search.ranks.end(), rank, greater<long long>() ) - search.ranks.begin();
+  search.ranks.insert( search.ranks.begin() + position, rank );
+  search.best.insert( search.best.begin() + position, route );
+  if( search.ranks.size() > search.count ) {
+    search.ranks.pop_back();
+    search.best.pop_back();
+  }
+}
+
+/**
+ * \brief Compares two routes by their negated rank, used to sort the best route to the front.
+ */
+static bool compareRank( const pair<long long, const TradeRoute*> &a, const pair<long long, const TradeRoute*> &b ) {
+  return a.first < b.first;
+}
+
+//! Merges the best routes of several searches.
+/**
+ * The routes with the same rank are ordered by the searches, as if the searches were
+ * done one after another.
+ * \return the best routes, has to be deleted by the caller.
+ */
+vector<TradeRoute> * TradeRoutes::merge( vector<Search> &searches, unsigned int count ) {
+  vector<pair<long long, const TradeRoute*> > all;
+  for( unsigned int i = 0; i < searches.size(); i++ )
+    for( unsigned int j = 0; j < searches[i].best.size(); j++ )
+      all.push_back( make_pair( -searches[i].ranks[j], &searches[i].best[j] ) );
+  stable_sort( all.begin(), all.end(), compareRank );
+
+  vector<TradeRoute> *result = new vector<TradeRoute>;
+  for( unsigned int i = 0; i < all.size() && i < count; i++ )
+    result->push_back( *all[i].second );
+  return result;
+}
@@ -0,0 +1,104 @@
+/**
+ * Copyright Jan-Philipp Kappmeier, Melanie Schmidt
+ * \file	TradeRoutes.h
+ * \brief	Declares the TradeRoutes, a search for profitable trade routes within a galaxy.
+ */
+#pragma once
+
+#include "wrappDef.h"
+#include <vector>
+
+class JobPool;
+
+//! Finds the most profitable routes of several jumps through a galaxy.
+/**
+ * The search works on tables that are filled by the text elite game: the market of
+ * each system, the distances between all systems and the systems that can be reached
+ * with a full tank. The prices of a system depend on a fluctuation byte that is drawn
+ * when the player arrives, so the game stores the expected market, the average over
+ * all fluctuations. Only the market of the start system is known exactly.
+ *
+ * A route is a sequence of jumps. On each jump the single good that gives the highest
+ * profit is bought at the start and sold at the destination, limited by the cash, the
+ * free cargo space for goods in tons and the available amount. The fuel needed for the
+ * jump is paid from the profit and the rest is used for the next jump. All routes up to
+ * the given number of jumps are searched, each prefix of a route is a route itself.
+ * A route is not extended if an upper bound of the rank of its extensions shows that
+ * none of them can be among the best routes found so far, so the search does not try
+ * every sequence of jumps.
+ *
+ * The routes are ranked by their profit or by their profit per light year. The search
+ * of the routes starting with different jumps is divided among the threads of a job
+ * pool that is shared with the world.
+ * Equal routes are ranked in the order in which they are found, so the result does not
+ * depend on the number of cores.
+ */
+class TradeRoutes {
+public:
+  static const unsigned int systemCount = 256;
+  static const unsigned int goodCount = 17;
+  static const unsigned int maxHops = 8;
+
+  //! The prices in tenths of credits and the available amounts of a market.
+  struct Market {
+    unsigned int price[goodCount];
+    unsigned int quantity[goodCount];
+  };
+
+  TradeRoutes( void );
+  ~TradeRoutes( void );
+
+  void setGalaxy( const unsigned short (*distances)[systemCount], const std::vector<int> *neighbours );
+  void setFuel( unsigned int maxFuel, unsigned int fuelCost );
+  void setInTons( unsigned int good, bool inTons );
+  void setMarket( unsigned int system, const Market &market );
+  void setJobPool( JobPool *pool );
+
+  std::vector<TradeRoute> * find( unsigned int start, const Market &startMarket, long cash, unsigned int holdspace,
+                                  unsigned int hops, unsigned int count, bool perFuel );
+  std::vector<TradeRoute> * findFromAll( long cash, unsigned int holdspace, unsigned int hops, bool perFuel );
+private:
+  //! The state of the search in one thread, the route that is currently extended.
+  struct Search {
+    unsigned int hops;
+    unsigned int count;
+    bool perFuel;
+    unsigned int holdspace;
+    unsigned int systems[maxHops + 1];
+    int goods[maxHops];
+    unsigned int amounts[maxHops];
+    long profits[maxHops];        // of each jump, after the fuel
+    std::vector<TradeRoute> best; // ordered by rank
+    std::vector<long long> ranks;
+  };
+  //! The parameters of a parallel search.
+  struct Jobs {
+    TradeRoutes *routes;
+    const Market *startMarket;
+    long cash;
+    std::vector<unsigned int> first; // the first jump of a find() job, or the start of findFromAll()
+    std::vector<Search> searches;
+  };
+  static void runFirst( void *context, unsigned int index );
+  static void runStart( void *context, unsigned int index );
+
+  static void init( Search &search, unsigned int hops, unsigned int count, bool perFuel, unsigned int holdspace );
+  void extend( Search &search, unsigned int depth, const Market &market, long cash, long profit, unsigned int fuel );
+  void jump( Search &search, unsigned int depth, const Market &market, unsigned int to, long cash, long profit, unsigned int fuel );
+  void store( Search &search, unsigned int depth, long profit, unsigned int fuel );
+  long choose( const Market &market, const Market &destination, unsigned int holdspace, long budget, int &good, unsigned int &amount );
+  void bound( unsigned int holdspace, unsigned int hops, bool perFuel );
+  bool canImprove( const Search &search, unsigned int depth, long profit, unsigned int fuel );
+  static std::vector<TradeRoute> * merge( std::vector<Search> &searches, unsigned int count );
+
+  const unsigned short (*distances)[systemCount];
+  const std::vector<int> *neighbours;
+  unsigned int maxFuel;
+  unsigned int fuelCost;
+  bool inTons[goodCount];
+  Market markets[systemCount];
+  static const unsigned int rankStepCount = 64;
+  long long rankSteps[rankStepCount];  // 0 and the powers of the square root of two
+  std::vector<long long> futureGain;   // for each rank step, number of jumps and system, see bound()
+  JobPool *pool;                // not owned, the searches are serial if it is 0
+};
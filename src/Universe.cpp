@@ -0,0 +1,167 @@
+/**
+ * Copyright Jan-Philipp Kappmeier, Melanie Schmidt
+ * \file	Universe.cpp
+ * \brief	The implementation of the Universe class.
+ */
+#include "Universe.h"
+#include <string.h>
+
+using namespace std;
+
+// the version of the cache files, has to be increased if the layout or the generation of the systems changes
+static const unsigned int universeVersion = 1;
+static const char universeMagic[4] = { 'M', 'U', 'N', 'I' };
+
+/**
+ * \brief Creates an empty universe.
+ */
+Universe::Universe( void ) {
+  memset( seeds, 0, sizeof( seeds ) );
+  systems = 0;
+  names = 0;
+  count = 0;
+  nameSize = 0;
+}
+
+/**
+ * \brief Destructor, does nothing. The mapping of the cache file is removed by the MappedFile.
+ */
+Universe::~Universe( void ) { }
+
+//! Maps a cache file into memory.
+/**
+ * The file is only used if it has the current version, the same seeds and sizes and
+ * the checksum matches. Otherwise the universe is empty afterwards and the galaxies
+ * have to be added.
+ * \param filename the cache file
+ * \param seeds the seed of each galaxy
+ * \return true if the file is valid and complete
+ */
+bool Universe::load( const string &filename, const unsigned short (*seeds)[3] ) {
+  create( seeds );
+  if( !file.open( filename ) || file.getSize() < sizeof( Header ) )
+    return false;
+  const Header *header = (const Header *)file.getData();
+  size_t recordBytes = galaxyCount * systemCount * sizeof( UniverseSystem );
+  if( memcmp( header->magic, universeMagic, 4 ) != 0 || header->version != universeVersion ||
+      header->recordSize != sizeof( UniverseSystem ) || header->galaxyCount != galaxyCount ||
+      header->systemCount != systemCount || memcmp( header->seeds, seeds, sizeof( header->seeds ) ) != 0 ||
+      header->nameSize == 0 || file.getSize() != sizeof( Header ) + recordBytes + header->nameSize ||
+      MappedFile::hash( file.getData() + sizeof( Header ), recordBytes + header->nameSize ) != header->checksum ) {
+    file.close();
+    return false;
+  }
+  const UniverseSystem *fileSystems = (const UniverseSystem *)(file.getData() + sizeof( Header ));
+  const char *fileNames = (const char *)(file.getData() + sizeof( Header ) + recordBytes);
+  bool valid = fileNames[header->nameSize - 1] == 0;
+  for( unsigned int i = 0; i < galaxyCount * systemCount && valid; i++ )
+    valid = fileSystems[i].nameOffset < header->nameSize;
+  if( !valid ) {
+    file.close();
+    return false;
+  }
+
+  systems = fileSystems;
+  names = fileNames;
+  count = galaxyCount * systemCount;
+  nameSize = header->nameSize;
+  return true;
+}
+
+//! Writes all galaxies into a cache file.
+/**
+ * \param filename the cache file, is overwritten
+ * \return true if the universe is complete and the file was written completely
+ */
+bool Universe::save( const string &filename ) {
+  if( !isComplete() )
+    return false;
+  FILE *output = 0;
+#ifndef MELITE_HEADLESS
+  fopen_s( &output, filename.c_str(), "wb" );
+#else
+  output = fopen( filename.c_str(), "wb" );
+#endif
+  if( !output )
+    return false;
+
+  Header header;
+  memset( &header, 0, sizeof( Header ) );
+  memcpy( header.magic, universeMagic, 4 );
+  header.version = universeVersion;
+  header.recordSize = sizeof( UniverseSystem );
+  header.galaxyCount = galaxyCount;
+  header.systemCount = systemCount;
+  header.nameSize = nameSize;
+  memcpy( header.seeds, seeds, sizeof( seeds ) );
+  header.checksum = checksum();
+
+  bool written = fwrite( &header, sizeof( Header ), 1, output ) == 1;
+  written = written && fwrite( systems, sizeof( UniverseSystem ), count, output ) == count;
+  written = written && fwrite( names, 1, nameSize, output ) == nameSize;
+  fclose( output );
+  if( !written )
+    remove( filename.c_str() ); // an incomplete file is rejected by load() anyway
+  return written;
+}
+
+//! Removes all systems, before the galaxies are generated with add().
+/**
+ * \param seeds the seed of each galaxy, stored to verify the cache file
+ */
+void Universe::create( const unsigned short (*seeds)[3] ) {
+  file.close();
+  memcpy( this->seeds, seeds, sizeof( this->seeds ) );
+  createdSystems.clear();
+  createdNames.clear();
+  createdSystems.reserve( galaxyCount * systemCount );
+  systems = 0;
+  names = 0;
+  count = 0;
+  nameSize = 0;
+}
+
+//! Adds the next system.
+/**
+ * The systems have to be added in the order of the galaxies and their numbers.
+ * \param system the system, the name offset is set
+ * \param name the name of the system
+ */
+void Universe::add( const UniverseSystem &system, const char *name ) {
+  createdSystems.push_back( system );
+  createdSystems.back().nameOffset = (unsigned short)createdNames.size();
+  createdNames.insert( createdNames.end(), name, name + strlen( name ) + 1 );
+  systems = &createdSystems[0];
+  names = &createdNames[0];
+  count = (unsigned int)createdSystems.size();
+  nameSize = (unsigned int)createdNames.size();
+}
+
+/**
+ * \brief Returns true if the systems of all galaxies are available.
+ */
+bool Universe::isComplete( void ) {
+  return count == galaxyCount * systemCount;
+}
+
+/**
+ * \brief Returns a system of a galaxy, the galaxies are numbered from 0.
+ */
+const UniverseSystem & Universe::getSystem( unsigned int galaxy, unsigned int number ) {
+  return systems[galaxy * systemCount + number];
+}
+
+/**
+ * \brief Returns the name of a system.
+ */
+const char * Universe::getName( const UniverseSystem &system ) {
+  return names + system.nameOffset;
+}
+
+/**
+ * \brief Computes the hash of the systems and names as stored in the cache file.
+ */
+unsigned int Universe::checksum( void ) {
+  unsigned int h = MappedFile::hash( (const unsigned char *)systems, count * sizeof( UniverseSystem ) );
+  return MappedFile::hash( (const unsigned char *)names, nameSize, h );
+}
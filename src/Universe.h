@@ -0,0 +1,78 @@
+/**
+ * Copyright Jan-Philipp Kappmeier, Melanie Schmidt
+ * \file	Universe.h
+ * \brief	Declares the Universe, a table of the systems of all galaxies that is cached in a file.
+ */
+#pragma once
+
+#include "MappedFile.h"
+#include <string>
+#include <vector>
+
+//! A system as stored in the universe table. The values have the ranges of the original game.
+struct UniverseSystem {
+  unsigned char x;
+  unsigned char y;
+  unsigned char economy;
+  unsigned char govtype;
+  unsigned char techlev;
+  unsigned char population;
+  unsigned short productivity;
+  unsigned short radius;
+  unsigned char goatsoupseed[4];
+  unsigned short nameOffset;      // position of the name in the name table
+};
+
+//! The systems of all galaxies, generated once and stored in a cache file.
+/**
+ * The systems of each galaxy are generated from a seed, which is changed for each
+ * system. The text elite game generates all galaxies with add() and saves them. At
+ * the next start the file is mapped into memory by load(), which only succeeds if
+ * the file was written from the same seeds, by the same version and is complete.
+ * The systems are then used directly from the mapped memory.
+ *
+ * The systems are stored as records of 16 bytes, ordered by galaxy, so a galaxy
+ * takes 4 kB. The names are stored behind the records, each terminated by a zero.
+ * Each system is found by its galaxy and number without search.
+ */
+class Universe {
+public:
+  static const unsigned int galaxyCount = 8;
+  static const unsigned int systemCount = 256;
+
+  Universe( void );
+  ~Universe( void );
+
+  bool load( const std::string &filename, const unsigned short (*seeds)[3] );
+  bool save( const std::string &filename );
+  void create( const unsigned short (*seeds)[3] );
+  void add( const UniverseSystem &system, const char *name );
+  bool isComplete( void );
+
+  const UniverseSystem & getSystem( unsigned int galaxy, unsigned int number );
+  const char * getName( const UniverseSystem &system );
+private:
+  Universe( const Universe & );
+  Universe & operator =( const Universe & );
+  unsigned int checksum( void );
+
+  //! The header of a cache file, followed by the systems and the names.
+  struct Header {
+    char magic[4];
+    unsigned int version;
+    unsigned int recordSize;
+    unsigned int galaxyCount;
+    unsigned int systemCount;
+    unsigned int nameSize;
+    unsigned short seeds[Universe::galaxyCount][3]; // the seed of the first system of each galaxy
+    unsigned int checksum;                          // of the systems and names
+  };
+  MappedFile file;
+  std::vector<UniverseSystem> createdSystems;
+  std::vector<char> createdNames;
+  unsigned short seeds[galaxyCount][3];
+  const UniverseSystem *systems;          // the created systems or the systems in the file
+  const char *names;
+  unsigned int count;
+  unsigned int nameSize;
+};
@@ -42,7 +42,7 @@ default:
   }
 }
 
-float Vector3::at( unsigned __int8 index ) {
+float Vector3::at( unsigned char index ) {
   switch( index ) {
 case 0:
   return this->x;
@@ -38,7 +38,7 @@ public:
   Vector3 operator =( const Vector3 &v );// assign value
 
   float at( Vector3Index index );
-  float at( unsigned __int8 index );
+  float at( unsigned char index );
 
   float length( void );
   void normalize( void );
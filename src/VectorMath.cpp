@@ -38,16 +38,27 @@ Vector3 VectorMath::normal( Vector3 p1, Vector3 p2, Vector3 p3 ) {
  * \param oVec base point of rotation
  */
 Vector3 VectorMath::rotateVector( float angle, Vector3 axis, Vector3 oVec ) {
+  // sine and cosine of the angle
+  float cosTheta = (float)cos( angle  * M_PI/180.0 );
+  float sinTheta = (float)sin( angle  * M_PI/180.0 );
+  return rotateVector( cosTheta, sinTheta, axis, oVec );
+}
+
+/**
+ * Rotates a vector around an axis. The sine and cosine of the angle are given,
+ * so they can be computed once if several vectors are rotated by the same angle.
+ * \param cosTheta cosine of the angle by which the vector is rotated
+ * \param sinTheta sine of the angle by which the vector is rotated
+ * \param axis rotation axis
+ * \param oVec base point of rotation
+ */
+Vector3 VectorMath::rotateVector( float cosTheta, float sinTheta, Vector3 axis, Vector3 oVec ) {
   Vector3 nVec;
 
   float x=axis.x;
   float y=axis.y;
   float z=axis.z;
 
-  // sine and cosine of the angle
-  float cosTheta = (float)cos( angle  * M_PI/180.0 );
-  float sinTheta = (float)sin( angle  * M_PI/180.0 );
-
   // new x
   nVec.x= (cosTheta + (1 - cosTheta)  * x  * x)	 * oVec.x;
   nVec.x += ((1 - cosTheta)  * x  * y - z  * sinTheta)	 * oVec.y;
@@ -29,5 +29,6 @@ class VectorMath{
 public:
   static Vector3 normal( Vector3 p1, Vector3 p2, Vector3 p3 );
   static Vector3 rotateVector( float angle, Vector3 axis, Vector3 vView );
+  static Vector3 rotateVector( float cosTheta, float sinTheta, Vector3 axis, Vector3 vView );
   static void drawEliteObject2(int numberOfFaces, Vector3 vertex[], long face[], Material material[]);
 };
\ No newline at end of file
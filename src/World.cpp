@@ -3,12 +3,14 @@
  * \file	World.cpp
  * \brief	Contains the World class, that contains all objects in the 3d game scenery.
  */
+#include "JobPool.h"
 #include "World.h" 
 #include "SpaceShip.h"
 #include "GlobalParameters.h"
-#include "Textures.h"
 #include "Wrapper.h"
+#ifndef MELITE_HEADLESS
 #include "Objects.h"
+#endif
 #include "FileAccess.h"
 #include "MovingObject.h"
 #include "Planet.h"
@@ -25,9 +27,13 @@
 #include "Star.h"
 #include "Planet.h"
 #include "SpaceStation.h"
+#include "Profiler.h"
 
 using namespace std;
 
+void error1( string error );
+void error2( string error );
+
 /** @name Object handling
  * These methods provide the basic object handling for the game world. In World::initialize() the world
  * is created. This function needs to be called each time, a new system is loaded. The other functions mainly
@@ -44,7 +50,14 @@ using namespace std;
  */
 void World::initialize() {
   // init the data structure
-  GameObjects.clear();
+  m_planets.clear();
+  m_drawable.clear();
+  m_ships.clear();
+  m_shipHandles.clear();
+  m_foreignShips.clear();
+  m_policeShips.clear();
+  m_removedShipSlots.clear();
+  m_simulationTime = 0;
 
   float lightspeed = 0.00815;
 
@@ -56,10 +69,7 @@ void World::initialize() {
   player->setStep( lightspeed/20.0 * 0.2 );  // 0.2 is a calibration value ;) greater value increases speed faster
   player->setMoveSpeed( player->getMaxSpeed()*0.5 );
 
-  GameObjects.push_back( player );
-
-  list<GameObject*>::iterator it = GameObjects.begin();
-  playerPosition = it;
+  m_player = player;
 
   // create the star(s)
   Star *sun = new Star( 0, 0, 0, 1000, star );
@@ -69,8 +79,8 @@ void World::initialize() {
   sun->setRotateAngle( 0 );
   sun->setRotateSpeed( 0 );
 
-  GameObjects.push_back( sun );
-  starPosition = ++it;
+  m_star = sun;
+  m_drawable.push_back( sun );
 
   // get planets info
   vector<PlanetInfoGraphical> planets = *World::getWorld()->getSystemPlanets();
@@ -94,10 +104,10 @@ void World::initialize() {
     planet->setRotateAngle((rand()%61-30));
     //planet->setRotateAngle( 0 );
     planet->setRotateSpeed( 0 );
-    GameObjects.push_back( planet );
+    m_planets.push_back( planet );
+    m_drawable.push_back( planet );
 	if (i == coriolisPlanetNr) 
 		coriolisPlanet = planet;
-    it++;
   }
   
   // set corolis planet rotate angle randomly, but in [-15,15] intervall
@@ -105,7 +115,7 @@ void World::initialize() {
   coriolisPlanet->setRotateAngle(0);
 
   // create coriolis station
-  SpaceStation *station = new SpaceStation( 1, Objects::getObjects()->getDisplayList( coriolis ) );
+  SpaceStation *station = new SpaceStation( 1, getMesh( coriolis ) );
   // calculate random position in orbit
   float sx, sy, sz;
   sx = coriolisPlanet->getPos().x;
@@ -118,8 +128,9 @@ void World::initialize() {
   //station->setPos(sx,sy,sz);
   station->setSpeed( 0.006 );
   station->setAxis( a ); // Vector3( 0, 0, 1 ) );
-  GameObjects.push_back( station );
-  stationPosition = ++it;
+  station->updatePose( m_simulationTime );
+  m_station = station;
+  m_drawable.push_back( station );
 
   playerStartDistance = 1000;
 
@@ -232,231 +243,274 @@ void World::initialize() {
 
 //! Destructs the game world.
 /**
- * Deletes all objects that have been inserted into the object list. As the list contains generic pointers
- * to objects of the type Objects::getObjects(), all object have to be casted into their original type. At last the
- * list is cleared itself. The next level can be initialized through World::initialize().
+ * Deletes all objects of the current system. As the objects are stored in typed lists, each object is
+ * deleted as its original type. The ships are deleted using the type stored in the ship table. The
+ * entries of the ship table are invalidated, so that handles to ships of the old system can not be
+ * used any more. The next level can be initialized through World::initialize().
  */
 void World::deinitialize() {
-  list<GameObject*>::iterator it = GameObjects.begin();
-  while( it !=GameObjects.end() ) {
-    PlayerObject * pl = dynamic_cast<PlayerObject*>(*it);
-    Star * st = dynamic_cast<Star*>(*it);
-    Planet * pln = dynamic_cast<Planet*>(*it);
-    PoliceShip * pol = dynamic_cast<PoliceShip*>(*it);
-    Pirate * pir = dynamic_cast<Pirate*>(*it);
-    Thargon * tha = dynamic_cast<Thargon*>(*it);
-    Merchant * mer = dynamic_cast<Merchant*>(*it);
-    SpaceShip * sh = dynamic_cast<SpaceShip*>(*it);
-    SpaceStation * sta = dynamic_cast<SpaceStation*>(*it);
-    if( pl ) {
-      delete pl;
-      it++;
-      continue;
-    }
-    if( st ) {
-      delete st;
-      it++;
-      continue;
-    }
-    if( pln ) {
-      delete pln;
-      it++;
-      continue;
-    }
-    if( pol ) {
-      delete pol;
-      it++;
-      continue;
-    }
-    if( pir ) {
-      delete pir;
-      it++;
-      continue;
-    }
-    if( tha ) {
-      delete tha;
-      it++;
-      continue;
-    }
-    if( mer ) {
-      delete mer;
-      it++;
-      continue;
-    }
-    if( sh ) {
-      delete sh;
-      it++;
-      continue;
-    }
-    if( sta ) {
-      delete sta;
-      it++;
-      continue;
-    }
-    MessageBox(0, "Unknown Type!", "World::deinitialize()", 0 );
-    it++;
+  for( unsigned int i=0; i < m_ships.size(); i++ ) {
+    ShipSlot &slot = m_shipSlots[m_shipHandles[i].index];
+    deleteShip( slot );
+    m_freeShipSlots.push_back( m_shipHandles[i].index );
   }
-  GameObjects.clear();
+  m_ships.clear();
+  m_shipHandles.clear();
+  m_foreignShips.clear();
+  m_policeShips.clear();
+  m_removedShipSlots.clear();
+
+  delete m_station;
+  m_station = 0;
+  for( unsigned int i=0; i < m_planets.size(); i++ )
+    delete m_planets[i];
+  m_planets.clear();
+  delete m_star;
+  m_star = 0;
+  delete m_player;
+  m_player = 0;
+  m_drawable.clear();
+  m_rayIndexValid = false;
 }
 
 //! Returns the current player object.
 /**
- * Uses an iterator that has been saved during initialization to find the player object in the list of
- * objects. The object is casted to PlayerObject and returned. The pointer can be saved but gets invalid
- * if a new system is loaded, that means World::deinitialize() and World::initialize() have been called.
+ * The pointer can be saved but gets invalid if a new system is loaded, that means World::deinitialize()
+ * and World::initialize() have been called.
  * \return a pointer to the current player object.
  */
 PlayerObject *World::getPlayer() {
-  PlayerObject * pl = dynamic_cast<PlayerObject*>(*playerPosition);
-  return pl;
+  return m_player;
 }
 
 //! Returns the star of the current system.
 /**
- * Uses an iterator that has been saved during initialization to find the star object in the list of objects.
- * The found object is casted to Star and returned. The pointer can be saved but gets invalid
- * if a new system is loaded, that means World::deinitialize() and World::initialize() have been called.
+ * The pointer can be saved but gets invalid if a new system is loaded, that means World::deinitialize()
+ * and World::initialize() have been called.
  * \return a pointer to the current systems star.
  */
 Star *World::getStar() {
-  Star * st = dynamic_cast<Star*>(*starPosition);
-  return st;
+  return m_star;
 }
 
-//! Returns a vector containing the planets of the current system.
+//! Returns the planets of the current system.
 /**
- * \fn std::vector<Planet*> * World::getPlanets()
- * Uses an iterator that has been saved during initialization to find the first planet object in the list of
- * objects. It iterates through the list beginning at the position of the first planet to find all the planets.
- * The iteration stops when the first non-planet object is found. It is assumed that all planets are inserted
- * one after another. The objects are casted to Planet and put into a vector. The pointers became invalid
- * if a new system is loaded, that means World::deinitialize() and World::initialize() have been called.
- * \return a pointer to a vector containing pointers to the planets. it is created in this function and has to be deleted from the caller.
+ * \fn const std::vector<Planet*> & World::getPlanets()
+ * The planets are stored in the order they were created, that is ordered by their distance to the star.
+ * The pointers became invalid if a new system is loaded, that means World::deinitialize() and
+ * World::initialize() have been called.
+ * \return the list of planets. it is owned by the world and must not be deleted.
  */
-vector<Planet*> * World::getPlanets() {
-  vector<Planet*> * planets = new vector<Planet*>;
-
-  if( starPosition == GameObjects.end() )
-    return planets;
-
-  list<GameObject*>::iterator it = starPosition;
-  it++;
-
-  Planet * pl;
-  while( it != GameObjects.end() && (pl = dynamic_cast<Planet*>(*it++)) != 0 )
-    planets->push_back( pl );
-
-  return planets;
+const vector<Planet*> & World::getPlanets() {
+  return m_planets;
 }
 
 //! Returns the station of the current system.
 /**
- * Uses an iterator that has been saved during initialization to find the station object in the list of objects.
- * The found object is casted to SpaceStation and returned. The pointer can be saved but gets invalid
- * if a new system is loaded, that means World::deinitialize() and World::initialize() have been called.
+ * The pointer can be saved but gets invalid if a new system is loaded, that means World::deinitialize()
+ * and World::initialize() have been called.
  * \return a pointer to the current systems station.
  */
 SpaceStation *World::getStation() {
-  SpaceStation * st = dynamic_cast<SpaceStation*>(*stationPosition);
-  return st;
+  return m_station;
 }
 
-//! Returns a list of all objects of type GraphicsObject.
+//! Returns a list of all objects of type GraphicsObject, except the ships.
 /**
- * \fn std::vector<GraphicsObject*> *World::getGraphicObjects()
- * Uses the saved iterator to the star to find all drawable objects in the list of objects. The found
- * objects are casted to GraphicsObject and pushed into a vector. The whole list started at the star 
- * position is iterated until the first object that can't be casted into GraphicsObject is found.
- * \return a pointer to a vector containing pointers to the objects. it is created in this function and has to be deleted from the caller.
+ * \fn const std::vector<GraphicsObject*> & World::getGraphicObjects()
+ * The list contains the star, the planets and the station in this order. The ships are not
+ * contained, they are accessed with getSpaceShips() and drawn grouped by their model.
+ * \return the list of drawable objects. it is owned by the world and must not be deleted.
  */
-vector<GraphicsObject*> *World::getGraphicObjects() {
-  vector<GraphicsObject*> * retObjects = new vector<GraphicsObject*>;
-
-  list<GameObject*>::iterator it = starPosition;
-
-  GraphicsObject * obj;
-  while( it!= GameObjects.end() && (obj = dynamic_cast<GraphicsObject*>(*it++)) != 0 )
-    retObjects->push_back( obj );
-
-  return retObjects;
+const vector<GraphicsObject*> & World::getGraphicObjects() {
+  return m_drawable;
 }
 
-
 //! Returns a list of all space ships.
 /**
- * \fn std::vector<SpaceShip*> * World::getSpaceShips()
- * Uses the saved iterator to the station to find all space ship objects in the list of objects. The found
- * objects are casted to SpaceShip and pushed into a vector. The whole list started at the station 
- * position and is iterated until the first object that can't be casted into SpaceShip is found. This list can
- * be used to update all ships and is used to perform the collision detection in World::deleteCrashedShips().
- * \return a pointer to a vector containing pointers to the objects. it is created in this function and has to be deleted from the caller.
+ * \fn const std::vector<SpaceShip*> & World::getSpaceShips()
+ * Contains all ships that have been created with one of the createNew-functions, including missiles.
+ * This list can be used to update all ships. The list is valid until the next ship is created or
+ * removed.
+ * \return the list of ships. it is owned by the world and must not be deleted.
  */
-vector<SpaceShip*> * World::getSpaceShips() {
-  vector<SpaceShip*> * retObjects = new vector<SpaceShip*>;
-
-  list<GameObject*>::iterator it = stationPosition;
-
-  if (it==GameObjects.end()) return retObjects;
-
-  it++;
-
-  SpaceShip * obj;
-  while( it!= GameObjects.end() && (obj = dynamic_cast<SpaceShip*>(*it++)) != 0 )
-    retObjects->push_back( obj );
-
-  return retObjects;
+const vector<SpaceShip*> & World::getSpaceShips() {
+  return m_ships;
 }
 
 //! Returns a list of all space ships that can move freely.
 /**
- * \fn std::vector<ForeignSpaceShip*> * World::getForeignSpaceShips()
- * Uses the saved iterator to the station to find all space ship objects in the list of objects. The found
- * objects are casted to ForeignSpaceShip and pushed into a vector. The whole list started at the station 
- * position and is iterated until the first object that can't be casted into ForeignSpaceShip is found. This list can
- * be used to update the positions and status of self acting ships.                                            
- * \return a pointer to a vector containing pointers to the objects. it is created in this function and has to be deleted from the caller.
+ * \fn const std::vector<ForeignSpaceShip*> & World::getForeignSpaceShips()
+ * Contains all self acting ships, that are pirates, thargons, merchants and police ships. This list
+ * can be used to update the positions and status of self acting ships.
+ * \return the list of ships. it is owned by the world and must not be deleted.
  */
-vector<ForeignSpaceShip*> * World::getForeignSpaceShips() {
-  vector<ForeignSpaceShip*> * retObjects = new vector<ForeignSpaceShip*>;
-
-  list<GameObject*>::iterator it = stationPosition;
-
-  if (it==GameObjects.end()) return retObjects;
+const vector<ForeignSpaceShip*> & World::getForeignSpaceShips() {
+  return m_foreignShips;
+}
 
-  it++;
+//! Returns a list of all police ships.
+/**
+ * \fn const std::vector<PoliceShip*> & World::getPoliceShips()
+ * \return the list of police ships. it is owned by the world and must not be deleted.
+ */
+const vector<PoliceShip*> & World::getPoliceShips() {
+  return m_policeShips;
+}
 
-  ForeignSpaceShip * obj;
-  while( it!= GameObjects.end() && (obj = dynamic_cast<ForeignSpaceShip*>(*it++)) != 0 )
-    retObjects->push_back( obj );
+//! Returns the handle of a ship.
+/**
+ * In contrast to the position in the list returned by World::getSpaceShips(), the handle does not
+ * change if other ships are removed.
+ * \param index the position of the ship in the list of space ships
+ * \return the handle of the ship, or an invalid handle if the index is too high
+ */
+ShipHandle World::getShipHandle( unsigned int index ) {
+  if( index >= m_shipHandles.size() )
+    return ShipHandle();
+  return m_shipHandles[index];
+}
 
-  return retObjects;
+//! Returns the ship belonging to a handle.
+/**
+ * \param handle the handle of the ship
+ * \return a pointer to the ship, or null if the ship has been removed in the meantime
+ */
+SpaceShip * World::getShip( ShipHandle handle ) {
+  if( handle.index >= m_shipSlots.size() )
+    return 0;
+  ShipSlot &slot = m_shipSlots[handle.index];
+  if( slot.generation != handle.generation || slot.ship == 0 )
+    return 0;
+  return slot.ship;
 }
 
-//! Returns a list of all police ships.
+//! Inserts a ship into the ship table and the typed lists.
 /**
- * \fn std::vector<PoliceShip*> * World::getPoliceShips()
- * Uses the saved iterator to the station to find all space ship objects in the list of objects. The found
- * objects are casted to PoliceShop and pushed into a vector if the cast was successful. 
- * We check all objects up to the end of the list. 
- * \return a pointer to a vector containing pointers to the objects. it is created in this function and has to be deleted from the caller.
- */vector <PoliceShip*> * World::getPoliceShips() {
-  vector<PoliceShip*> * retObjects = new vector<PoliceShip*>;
+ * A free entry of the ship table is reused, if one exists. The ship is appended to the lists of
+ * drawable objects and ships and, depending of the type, to the lists of foreign and police ships.
+ * \param ship the ship
+ * \param foreign the ship as self acting ship, or null
+ * \param police the ship as police ship, or null
+ * \param type the type that is used to delete the ship
+ * \return the handle of the new ship
+ */
+ShipHandle World::addShip( SpaceShip *ship, ForeignSpaceShip *foreign, PoliceShip *police, ShipType type ) {
+  ShipHandle handle;
+  if( m_freeShipSlots.empty() ) {
+    handle.index = (unsigned int)m_shipSlots.size();
+    ShipSlot slot;
+    slot.generation = 0;
+    m_shipSlots.push_back( slot );
+  } else {
+    handle.index = m_freeShipSlots.back();
+    m_freeShipSlots.pop_back();
+  }
+  ShipSlot &slot = m_shipSlots[handle.index];
+  slot.ship = ship;
+  slot.foreign = foreign;
+  slot.police = police;
+  slot.type = type;
+  slot.removed = false;
+  handle.generation = slot.generation;
+
+  m_ships.push_back( ship );
+  m_shipHandles.push_back( handle );
+  m_rayIndexValid = false;
+  if( foreign )
+    m_foreignShips.push_back( foreign );
+  if( police )
+    m_policeShips.push_back( police );
+  return handle;
+}
 
-  list<GameObject*>::iterator it = stationPosition;
+//! Marks a ship to be removed by World::removeMarkedShips().
+/**
+ * \param index the position of the ship in the list of space ships
+ */
+void World::markShipRemoved( unsigned int index ) {
+  ShipSlot &slot = m_shipSlots[m_shipHandles[index].index];
+  if( slot.removed )
+    return;
+  slot.removed = true;
+  m_removedShipSlots.push_back( m_shipHandles[index].index );
+}
 
-  if (it==GameObjects.end()) return retObjects;
+//! Removes all marked ships.
+/**
+ * The typed lists are compacted in one pass each, the order of the remaining objects is not changed.
+ * After that the ships are deleted and their entries in the ship table are freed.
+ */
+void World::removeMarkedShips( void ) {
+  if( m_removedShipSlots.empty() )
+    return;
 
-  it++;
+  unsigned int count = 0;
+  for( unsigned int i=0; i < m_ships.size(); i++ ) {
+    if( m_shipSlots[m_shipHandles[i].index].removed )
+      continue;
+    m_ships[count] = m_ships[i];
+    m_shipHandles[count] = m_shipHandles[i];
+    count++;
+  }
+  m_ships.resize( count );
+  m_shipHandles.resize( count );
+  m_rayIndexValid = false;
+
+  // the remaining lists are compared with the few removed ships only
+  count = 0;
+  for( unsigned int i=0; i < m_foreignShips.size(); i++ ) {
+    bool removed = false;
+    for( unsigned int j=0; j < m_removedShipSlots.size() && !removed; j++ )
+      removed = m_foreignShips[i] == m_shipSlots[m_removedShipSlots[j]].foreign;
+    if( !removed )
+      m_foreignShips[count++] = m_foreignShips[i];
+  }
+  m_foreignShips.resize( count );
+
+  count = 0;
+  for( unsigned int i=0; i < m_policeShips.size(); i++ ) {
+    bool removed = false;
+    for( unsigned int j=0; j < m_removedShipSlots.size() && !removed; j++ )
+      removed = m_policeShips[i] == m_shipSlots[m_removedShipSlots[j]].police;
+    if( !removed )
+      m_policeShips[count++] = m_policeShips[i];
+  }
+  m_policeShips.resize( count );
 
-  PoliceShip * obj;
-  while( it!= GameObjects.end() )
-  {
-	obj = dynamic_cast<PoliceShip*>(*it++);
-	if ( obj != 0)
-		retObjects->push_back( obj );
+  for( unsigned int j=0; j < m_removedShipSlots.size(); j++ ) {
+    deleteShip( m_shipSlots[m_removedShipSlots[j]] );
+    m_freeShipSlots.push_back( m_removedShipSlots[j] );
   }
+  m_removedShipSlots.clear();
+}
 
-  return retObjects;
+//! Deletes a ship as its original type and invalidates the entry in the ship table.
+/**
+ * \param slot the entry of the ship table
+ */
+void World::deleteShip( ShipSlot &slot ) {
+  switch( slot.type ) {
+case pirateShip:
+  delete static_cast<Pirate*>( slot.ship );
+  break;
+case thargonShip:
+  delete static_cast<Thargon*>( slot.ship );
+  break;
+case merchantShip:
+  delete static_cast<Merchant*>( slot.ship );
+  break;
+case policeShip:
+  delete static_cast<PoliceShip*>( slot.ship );
+  break;
+default:
+  delete slot.ship;
+  }
+  slot.ship = 0;
+  slot.foreign = 0;
+  slot.police = 0;
+  slot.removed = false;
+  slot.generation++;
 }
 
 //! Creates a new space ship.          
@@ -470,9 +524,9 @@ vector<ForeignSpaceShip*> * World::getForeignSpaceShips() {
  * \return a pointer to the new created ship
  */
 SpaceShip * World::createNewSpaceShip( ObjectName objectType, float radius ) {
-  SpaceShip *ship = new SpaceShip( radius, Objects::getObjects()->getDisplayList( objectType ) );
+  SpaceShip *ship = new SpaceShip( radius, getMesh( objectType ) );
   ship->setView( FileAccess::getObjectView( objectType ) );
-  GameObjects.push_back( ship );
+  addShip( ship, 0, 0, genericShip );
 
   return ship;
 }
@@ -485,10 +539,10 @@ SpaceShip * World::createNewSpaceShip( ObjectName objectType, float radius ) {
  * \param maxSpeed The maximum speed of the new Thargon.
  */
 Thargon * World::createNewThargon( ObjectName objectType, float radius, PlayerObject *player, float maxSpeed ) {
-  Thargon *ship = new Thargon( radius, Objects::getObjects()->getDisplayList( objectType ), player, maxSpeed );
+  Thargon *ship = new Thargon( radius, getMesh( objectType ), player, maxSpeed );
   ship->setView( FileAccess::getObjectView( objectType ) );
 
-  GameObjects.push_back( ship );
+  addShip( ship, ship, 0, thargonShip );
 
   return ship;
 }
@@ -501,10 +555,10 @@ Thargon * World::createNewThargon( ObjectName objectType, float radius, PlayerOb
  * \param maxSpeed The maximum speed of the new pirate.
  */
 Pirate* World::createNewPirate( ObjectName objectType, float radius, PlayerObject *player, float maxSpeed ) {
-  Pirate *ship = new Pirate( radius, Objects::getObjects()->getDisplayList( objectType ), player, maxSpeed );
+  Pirate *ship = new Pirate( radius, getMesh( objectType ), player, maxSpeed );
   ship->setView( FileAccess::getObjectView( objectType ) );
 
-  GameObjects.push_back( ship );
+  addShip( ship, ship, 0, pirateShip );
 
   return ship;
 }
@@ -517,10 +571,10 @@ Pirate* World::createNewPirate( ObjectName objectType, float radius, PlayerObjec
  * \param aim The direction of the merchant.
  */
 Merchant * World::createNewMerchant( ObjectName objectType, float radius, Planet * planet, Vector3 aim ) {
-  Merchant *ship = new Merchant( radius, Objects::getObjects()->getDisplayList( objectType ), planet, aim );
+  Merchant *ship = new Merchant( radius, getMesh( objectType ), planet, aim );
   ship->setView( FileAccess::getObjectView( objectType ) );
 
-  GameObjects.push_back( ship );
+  addShip( ship, ship, 0, merchantShip );
 
   return ship;
 }
@@ -534,97 +588,275 @@ Merchant * World::createNewMerchant( ObjectName objectType, float radius, Planet
  * \param maxSpeed The maximum speed of the new police ship.
  */
 PoliceShip * World::createNewPoliceShip( ObjectName objectType, float radius, std::vector<Vector3> point, PlayerObject * player, float maxSpeed ) {
-  PoliceShip *ship = new PoliceShip( radius, Objects::getObjects()->getDisplayList( objectType ), point, player, maxSpeed );
+  PoliceShip *ship = new PoliceShip( radius, getMesh( objectType ), point, player, maxSpeed );
   ship->setView( FileAccess::getObjectView( objectType ) );
 
- GameObjects.push_back( ship );
+  addShip( ship, ship, ship, policeShip );
 
   return ship;
 }
 
-//! Checks if ships have hit each other and deletes them if necessary.
+//! Returns the mesh for an object type.
 /**
- * The list of objects is iterated by two iterators starting at the position of the station. The second
- * iterator always starts one position on as the first. This procedure avoids testing a pair of ships two 
- * times. For each pair the distance between the centers is calculated and it is checked if they hit ech
- * other using the collision radius. If that happens, both ships are deleted from the list. As the deleting
- * invalidates the iterators a iterator which leads to last previous ship in the list is saved. If one of
- * the two ships (in fact, it could ouly be the first one) is the coriolis station, it is not deleted because
- * it is indestructible.
+ * The headless build loads no models, there all objects are created without mesh.
+ * \param objectType the type of the object
+ * \return the mesh, or null in the headless build
  */
-void World::deleteCrashedShips( void ) {
-  list<GameObject*>::iterator iti = stationPosition;
-  list<GameObject*>::iterator itj = stationPosition;
+Mesh * World::getMesh( ObjectName objectType ) {
+#ifndef MELITE_HEADLESS
+  return Objects::getObjects()->getMesh( objectType );
+#else
+  return 0;
+#endif
+}
 
-  if( itj == GameObjects.end() )
-    return;
-  //itj++;
-
-  GraphicsObject* goi;
-  GraphicsObject* goj;
-  while( iti != GameObjects.end() ) {
-    itj = iti;
-    itj++;
-    while( itj != GameObjects.end() ) {
-      // check if iti and itj have a collision
-      goi = dynamic_cast<GraphicsObject*>(*iti);
-      goj = dynamic_cast<GraphicsObject*>(*itj);
-
-      Vector3 distVector = goi->getPos() - goj->getPos();
-      float dist = distVector.length();
-
-      if( dist - goi->getCollisionRadius() - goj->getCollisionRadius() <= 0 ) {
-        // collision occured
-        list<GameObject*>::iterator pred = iti;
-        pred--;
-        // check for coriolis
-        SpaceStation* st = getStation();
-        if( *iti != st )
-          GameObjects.erase( iti );
-        else
-          pred = iti;
-        //if( *itj != st )  // this can't happen if the station is always in front of the other ships
-        //  Objects::getObjects().erase( itj );
-        //else
-        //  pred = iti;
-        // delete both objects if
-          GameObjects.erase( itj );
-        
-        iti = pred;
-        itj = pred;
-        //if( itj != Objects::getObjects().end() )
-          itj++;
-      } else {
-        itj++;
+//! The parameters of the jobs that let the self acting ships decide how they steer.
+struct SteeringJobs {
+  const vector<ForeignSpaceShip*> *ships;
+  float t;
+};
+
+/**
+ * \brief Lets a self acting ship decide how it steers. Called by the JobPool with a SteeringJobs structure.
+ */
+static void decideSteering( void *context, unsigned int index ) {
+  SteeringJobs *jobs = static_cast<SteeringJobs*>( context );
+  ForeignSpaceShip *ship = (*jobs->ships)[index];
+  if( ship != 0 )
+    ship->decide( jobs->t );
+}
+
+//! Advances the simulation of the current system by one time step.
+/**
+ * The player and all ships are moved, the planets are placed on their orbits
+ * and crashed and destroyed ships are removed. Ships that shoot hit the front
+ * shield of the player if their laser reaches the player. The simulation time is the sum of all time steps since
+ * World::initialize(), so a run with the same steps always gives the same result.
+ * Nothing is drawn and no input is handled, so the function can be used without
+ * a window, e. g. in the headless build.
+ *
+ * The offsets of the ships to the player and the movement of the ships are computed
+ * in batches over a ShipStates buffer, the ships only steer and update their weapons
+ * and shields on their own. The self acting ships decide against a copy of the player
+ * state, in parallel for large encounters, and their decisions are applied in the
+ * order of the ships, so the result does not depend on the number of threads. The
+ * collision test, the ship AI and the movement are
+ * measured as zones of the Profiler. The state of the player and the ships before
+ * the step is kept, see interpolateStates().
+ * \param deltaTime the length of the time step in milliseconds
+ */
+void World::tick( DWORD deltaTime ) {
+  ProfileZone zone( "tick" );
+  m_simulationTime += deltaTime;
+  m_rayIndexValid = false;
+
+  m_player->keepState();
+  for( unsigned int i=0; i < m_ships.size(); i++ )
+    m_ships[i]->keepState();
+
+  m_player->update( deltaTime );
+
+  // move the planets on their orbits
+  updatePositions( m_simulationTime );
+
+  // delete all objects that have hit each other
+  {
+    ProfileZone collisionZone( "collision" );
+    deleteCrashedShips();
+    deleteDestroyedShips();
+  }
+
+  // the self acting ships steer towards the player, compute all offsets at once
+  {
+    ProfileZone aiZone( "ai" );
+    m_shipStates->clear();
+    for( unsigned int i=0; i < m_ships.size(); i++ )
+      m_shipStates->add( m_ships[i]->getPos(), m_ships[i]->getView(), m_ships[i]->getSpeed() );
+    m_shipStates->computeOffsets( m_player->getPos() );
+    PlayerSnapshot player;
+    player.pos = m_player->getPos();
+    player.view = m_player->getView();
+    player.speed = m_player->getSpeed();
+    m_steeredShips.resize( m_ships.size() );
+    for( unsigned int i=0; i < m_ships.size(); i++ ) {
+      ForeignSpaceShip *foreign = m_shipSlots[m_shipHandles[i].index].foreign;
+      if( foreign != 0 )
+        foreign->setPlayerState( player, m_shipStates->getOffset( i ), m_shipStates->getDistance( i ) );
+      m_steeredShips[i] = foreign;
+    }
+
+    // the ships only store their decisions, which are applied in the order of the ships
+    SteeringJobs jobs = { &m_steeredShips, (float)deltaTime };
+    if( m_ships.size() >= PARALLEL_STEERING_SHIPS )
+      m_jobPool->run( decideSteering, &jobs, (unsigned int)m_ships.size() );
+    else
+      for( unsigned int i=0; i < m_ships.size(); i++ )
+        decideSteering( &jobs, i );
+
+    for( unsigned int i=0; i < m_ships.size(); i++ ) {
+      if( m_steeredShips[i] != 0 )
+        m_steeredShips[i]->applySteering();
+      else
+        m_ships[i]->steer( deltaTime );
+      m_ships[i]->updateSystems( deltaTime );
+      if( m_ships[i]->isShooting() ) {
+        // the laser stops at the first object, only the player takes damage
+        m_rayHits.clear();
+        castRay( m_ships[i]->getPos(), m_ships[i]->getView(), LASER_RANGE, i, m_rayHits );
+        if( !m_rayHits.empty() && m_rayHits[0].id == getPlayerRayId() )
+          m_player->receiveHitFront( deltaTime );
       }
     }
-    iti++;
   }
+
+  // move all ships with their new view and speed
+  ProfileZone movementZone( "movement" );
+  m_shipStates->clear();
+  for( unsigned int i=0; i < m_ships.size(); i++ )
+    m_shipStates->add( m_ships[i]->getPos(), m_ships[i]->getView(), m_ships[i]->getSpeed() );
+  m_shipStates->advance( (float)deltaTime );
+  for( unsigned int i=0; i < m_ships.size(); i++ )
+    m_ships[i]->setPos( m_shipStates->getPos( i ) );
+  m_rayIndexValid = false;
 }
 
-//! Checks if ships were distroyed and deletes the objects if necessary.
+//! Moves the player and the ships to their state between the last two steps.
 /**
- * The list of objects is iterated by an iterator. The objects are casted to ships and it is checked
- * if they are destroyed.
+ * Used to draw the world if the frames do not coincide with the simulation steps.
+ * The simulated state has to be set again with restoreStates() before the next
+ * call of tick().
+ * \param alpha the part of a step that has passed since the last step, between 0 and 1
  */
-void World::deleteDestroyedShips( void ) {
-  list<GameObject*>::iterator it = stationPosition;
+void World::interpolateStates( float alpha ) {
+  m_player->interpolate( alpha );
+  for( unsigned int i=0; i < m_ships.size(); i++ )
+    m_ships[i]->interpolate( alpha );
+}
+
+/**
+ * \brief Sets the player and the ships back to their state after the last step.
+ */
+void World::restoreStates( void ) {
+  m_player->restoreState();
+  for( unsigned int i=0; i < m_ships.size(); i++ )
+    m_ships[i]->restoreState();
+}
+
+//! Returns the time that has been simulated in the current system.
+/**
+ * \return the sum of all time steps since World::initialize() in milliseconds
+ */
+unsigned long World::getSimulationTime( void ) {
+  return m_simulationTime;
+}
 
-  if( it ==GameObjects.end() )
+//! Moves the star and the planets to their positions at the given time and spins the station.
+/**
+ * The positions and the pose of the station are cached by the objects, so all following
+ * queries in the same update are cheap and need no OpenGL context.
+ * \param time the time in milliseconds since the start of the game
+ */
+void World::updatePositions( long time ) {
+  m_star->updatePosition( time );
+  for( unsigned int i=0; i < m_planets.size(); i++ )
+    m_planets[i]->updatePosition( time );
+  m_station->updatePose( time );
+}
+
+//! Checks if ships have hit each other and deletes them if necessary.
+/**
+ * The station and all ships are inserted into a sweep and prune index over their collision spheres,
+ * which returns only the pairs that really intersect. Both ships of such a pair are marked to be
+ * removed. A ship that has already been marked is not taken into account for further pairs. The
+ * coriolis station is never removed because it is indestructible. At last, all marked ships are
+ * removed at once.
+ */
+void World::deleteCrashedShips( void ) {
+  if( m_station == 0 )
     return;
-  it++;
-
-  SpaceShip* go;
-  while( it != GameObjects.end() ) {
-    go = dynamic_cast<SpaceShip*>(*it);
-    if( go->isDestroyed() ) {
-      list<GameObject*>::iterator pred = it;
-      pred--;
-      GameObjects.erase( it );
-      it = pred;
-    }
-    it++;
+
+  // the station gets the id behind the last ship
+  const unsigned int stationId = (unsigned int)m_ships.size();
+  m_collisionIndex->clear();
+  m_collisionIndex->insert( m_station->getPos(), m_station->getCollisionRadius(), stationId );
+  for( unsigned int i=0; i < m_ships.size(); i++ )
+    m_collisionIndex->insert( m_ships[i]->getPos(), m_ships[i]->getCollisionRadius(), i );
+  m_collisionIndex->update();
+
+  m_collisionPairs.clear();
+  m_collisionIndex->findPairs( m_collisionPairs );
+
+  for( unsigned int k=0; k < m_collisionPairs.size(); k++ ) {
+    unsigned int i = m_collisionPairs[k].first;
+    unsigned int j = m_collisionPairs[k].second;
+    if( i != stationId && m_shipSlots[m_shipHandles[i].index].removed )
+      continue;
+    if( j != stationId && m_shipSlots[m_shipHandles[j].index].removed )
+      continue;
+    // collision occured, delete both objects
+    if( i != stationId )
+      markShipRemoved( i );
+    if( j != stationId )
+      markShipRemoved( j );
   }
+  removeMarkedShips();
+}
+
+//! Checks if ships were distroyed and deletes the objects if necessary.
+/**
+ * The list of ships is iterated and each ship that is destroyed is marked. The marked ships are removed
+ * at once after that.
+ */
+void World::deleteDestroyedShips( void ) {
+  for( unsigned int i=0; i < m_ships.size(); i++ )
+    if( m_ships[i]->isDestroyed() )
+      markShipRemoved( i );
+  removeMarkedShips();
+}
+
+//! Finds all objects that are hit by a ray, sorted by their distance to the origin.
+/**
+ * The station, the ships and the player are tested with their radius, using a sweep and prune
+ * index that is rebuilt if the objects have moved. A ship is identified by its position in the
+ * list of space ships, the station and the player by getStationRayId() and getPlayerRayId(). The
+ * ids are valid until ships are added or removed.
+ * \param origin the start point of the ray
+ * \param direction the direction of the ray
+ * \param maxDistance the length of the ray
+ * \param ignoreId the id of an object that is not hit, usually the shooting object
+ * \param hits the hits are appended to this vector
+ */
+void World::castRay( const Vector3 &origin, const Vector3 &direction, float maxDistance, unsigned int ignoreId, std::vector<RayHit> &hits ) {
+  if( !m_rayIndexValid )
+    updateRayIndex();
+  m_rayIndex->castRay( origin, direction, maxDistance, ignoreId, hits );
+}
+
+/**
+ * \brief Returns the id of the station in the results of castRay().
+ */
+unsigned int World::getStationRayId( void ) {
+  return (unsigned int)m_ships.size();
+}
+
+/**
+ * \brief Returns the id of the player in the results of castRay().
+ */
+unsigned int World::getPlayerRayId( void ) {
+  return (unsigned int)m_ships.size() + 1;
+}
+
+//! Inserts the station, the ships and the player at their current positions into the ray index.
+void World::updateRayIndex( void ) {
+  m_rayIndex->clear();
+  if( m_station != 0 )
+    m_rayIndex->insert( m_station->getPos(), m_station->getRadius(), getStationRayId() );
+  for( unsigned int i=0; i < m_ships.size(); i++ )
+    m_rayIndex->insert( m_ships[i]->getPos(), m_ships[i]->getRadius(), i );
+  if( m_player != 0 )
+    m_rayIndex->insert( m_player->getPos(), m_player->getRadius(), getPlayerRayId() );
+  m_rayIndex->update();
+  m_rayIndexValid = true;
 }
 //@}
 
@@ -660,8 +892,21 @@ World *World::getWorld ( void ) {
  * of planets is created. At least the player status is initialized.
  */
 World::World() {
+  m_simulationTime = 0;
+  m_player = 0;
+  m_star = 0;
+  m_station = 0;
+  m_collisionIndex = new SweepAndPrune();
+  m_rayIndex = new SweepAndPrune();
+  m_rayIndexValid = false;
+  m_shipStates = new ShipStates();
+  m_jobPool = new JobPool();
+  m_bestRouteSystem = -1;
+  m_bestRouteCash = 0;
+  m_bestRouteHoldspace = 0;
 
   wrapper = new Wrapper( &error1, &error2 );
+  wrapper->setJobPool( m_jobPool ); // the trade route search uses the threads of the ships
 
   srand(351);
   for( unsigned int i=0; i < 256; i++ )
@@ -704,6 +949,10 @@ World::~World( void ) {
   }
 
   delete wrapper;
+  delete m_collisionIndex;
+  delete m_rayIndex;
+  delete m_shipStates;
+  delete m_jobPool;
 }
 //@}
 
@@ -722,7 +971,7 @@ World::~World( void ) {
  * \param number a number
  * \return TextureName for the number
  */
-TextureName World::getPlanetTexture( unsigned __int8 number ) {
+TextureName World::getPlanetTexture( unsigned char number ) {
   switch( number ) {
 case 0:
   return planet_ss_earth;
@@ -803,7 +1052,7 @@ TextureName World::getPlanetTextureR( bool reset ) {
   if( reset )
     usedTextures.clear();
 
-  unsigned __int8 num;
+  unsigned char num;
   bool newTexture;
   do {
     newTexture = false;
@@ -825,7 +1074,7 @@ TextureName World::getPlanetTextureR( bool reset ) {
  * \param number the number of the texture
  * \return the TextureName for the texture
  */
-TextureName World::getStarTexture( unsigned __int8 number ) {
+TextureName World::getStarTexture( unsigned char number ) {
   switch( number ) {
 case 0:
   return star_sun;
@@ -874,7 +1123,7 @@ case 11:
  * \return the TextureName of the chosen texture
  */
 TextureName World::getStarTextureR( ) {
-  unsigned __int8 num = rand()%11;
+  unsigned char num = rand()%11;
   return getStarTexture( num );
 }
 
@@ -893,7 +1142,7 @@ SystemInfo World::getSystemInfo() {
  * \param number internal number of the system which is asked for
  * \return a SystemInfo object containing the information
  */
-SystemInfo World::getSystemInfo( unsigned __int8 number ) {
+SystemInfo World::getSystemInfo( unsigned char number ) {
   // TODO: size is not correct, number of planets shall be calculated and
   //graphical information can be submitted directly?
   SystemInfo sysinfo;
@@ -921,7 +1170,7 @@ SystemInfo World::getSystemInfo( unsigned __int8 number ) {
  * \param number internal number of the system whose name is asked for
  */
 string World::getSystemName( int number ) {
-  return wrapper->getSystemInfo( number ).name;
+  return wrapper->getSystemInfo( number, false ).name;
 }
 
 //! Returns a vector of planets for the current system.
@@ -939,7 +1188,7 @@ vector<PlanetInfoGraphical>  * World::getSystemPlanets() {
  * \param number the system number of the system whose planets are asked for
  * \return a pointer to a vector containing PlanetInfoGraphical objects
  */
-vector<PlanetInfoGraphical>  * World::getSystemPlanets( unsigned __int8 number ) {
+vector<PlanetInfoGraphical>  * World::getSystemPlanets( unsigned char number ) {
   return systemPlanets[number];
 }
 
@@ -1018,8 +1267,9 @@ vector<PlanetInfoGraphical>  * World::getSystemPlanetsR() {
  * full fuel amount and the systems which are reachable with the current fuel
  * amount.
  * \param systemList specifies the systems that should be returned
+ * \param withDescription specifies if the goat soup descriptions are generated
  */
-vector<SystemInfo> *World::getSystems( SystemLists systemList ) {
+vector<SystemInfo> *World::getSystems( SystemLists systemList, bool withDescription ) {
   // TODO: return all systems and reachable
   vector<SystemInfo> *systems;
   switch( systemList ) {
@@ -1031,11 +1281,11 @@ case nearSystems:
     // find out maximal/minimal x and y positions
     vector<int> *localSystems = wrapper->getLocalSystems();
     Position maxPos, minPos; // positions are unsigned integers in textelite --> 0 is minimal
-    maxPos.x = wrapper->getSystemInfo(localSystems->at(0)).posx;
-    maxPos.y = wrapper->getSystemInfo(localSystems->at(0)).posy;
+    maxPos.x = wrapper->getSystemInfo(localSystems->at(0), false).posx;
+    maxPos.y = wrapper->getSystemInfo(localSystems->at(0), false).posy;
     minPos = maxPos;
     for(unsigned int i = 0; i < localSystems->size(); i++) {
-      System reachableSystem = wrapper->getSystemInfo(localSystems->at(i));
+      System reachableSystem = wrapper->getSystemInfo(localSystems->at(i), false);
       if( reachableSystem.posx < minPos.x )
         minPos.x = reachableSystem.posx;
       if( reachableSystem.posy < minPos.y )
@@ -1047,7 +1297,7 @@ case nearSystems:
     }
     localSystems->clear();
     delete localSystems;
-    systems = getSystems( minPos.x, maxPos.x, minPos.y, maxPos.y );
+    systems = getSystems( minPos.x, maxPos.x, minPos.y, maxPos.y, withDescription );
   }
   break;
 case maximalReachable:
@@ -1056,7 +1306,7 @@ case maximalReachable:
     vector<int> *localSystems = wrapper->getLocalSystems();
     for(unsigned int i = 0; i < localSystems->size(); i++) {
       SystemInfo sysinfo;
-      System wsystem = wrapper->getSystemInfo(localSystems->at(i));
+      System wsystem = wrapper->getSystemInfo(localSystems->at(i), withDescription);
       sysinfo.name = wsystem.name;
       sysinfo.pos.x = wsystem.posx;
       sysinfo.pos.y = wsystem.posy;
@@ -1089,15 +1339,16 @@ case reachable:
  * \param right specifies the rightmost coordinate 
  * \param bottom specifies the lowest coordinate
  * \param top specifies the highest coordinate
+ * \param withDescription specifies if the goat soup descriptions are generated
  */
-std::vector<SystemInfo> *World::getSystems( int left, int right, int bottom, int top ) {
+std::vector<SystemInfo> *World::getSystems( int left, int right, int bottom, int top, bool withDescription ) {
   vector<SystemInfo> *systems = new vector<SystemInfo>;
 
   vector<int> *localSystems = wrapper->getSystemsInRectangle( left, right, bottom, top );
 
   for(unsigned int i = 0; i < localSystems->size(); i++) {
     SystemInfo sysinfo;
-    System wsystem = wrapper->getSystemInfo(localSystems->at(i));
+    System wsystem = wrapper->getSystemInfo(localSystems->at(i), withDescription);
     sysinfo.name = wsystem.name;
     sysinfo.pos.x = wsystem.posx;
     sysinfo.pos.y = wsystem.posy;
@@ -1131,7 +1382,7 @@ TextureName World::getSystemStarTexture() {
  * \return the TextureName for the star of any system.
  * \param number specifies the system 
  */
-TextureName World::getSystemStarTexture( unsigned __int8 number ) {
+TextureName World::getSystemStarTexture( unsigned char number ) {
   return systemStars.at( number );
 }
 
@@ -1209,6 +1460,43 @@ vector<MarketplaceItem> * World::getCurrentMarketplace() {
   return wrapper->getCurrentMarketplace();
 }
 
+//! Finds the most profitable trade routes from the current system.
+/**
+ * \param hops the maximal number of jumps of a route
+ * \param count the maximal number of routes
+ * \param perFuel ranks the routes by profit per light year instead of profit
+ * \return the routes, the best first. Has to be deleted by the caller.
+ */
+vector<TradeRoute> * World::findTradeRoutes( unsigned int hops, unsigned int count, bool perFuel ) {
+  return wrapper->findTradeRoutes( hops, count, perFuel );
+}
+
+//! Finds the most profitable trade route from each system, used for balancing.
+vector<TradeRoute> * World::findTradeRoutesFromAll( float cash, unsigned int holdspace, unsigned int hops, bool perFuel ) {
+  return wrapper->findTradeRoutesFromAll( cash, holdspace, hops, perFuel );
+}
+
+//! Gets the most profitable trade route from the current system.
+/**
+ * The route has at most TRADE_ROUTE_HOPS jumps. It is searched again only if the
+ * system, the cash or the free holdspace has changed, so it can be queried in each frame.
+ * \return the route, without jumps if no route gives a profit
+ */
+const TradeRoute & World::getBestTradeRoute( void ) {
+  int system = wrapper->getCurrentSystem();
+  float cash = wrapper->getCurrentCash();
+  unsigned int holdspace = wrapper->getFreeHoldspace();
+  if( system != m_bestRouteSystem || cash != m_bestRouteCash || holdspace != m_bestRouteHoldspace ) {
+    vector<TradeRoute> *routes = wrapper->findTradeRoutes( TRADE_ROUTE_HOPS, 1, false );
+    m_bestRoute = routes->empty() ? TradeRoute() : routes->at( 0 );
+    delete routes;
+    m_bestRouteSystem = system;
+    m_bestRouteCash = cash;
+    m_bestRouteHoldspace = holdspace;
+  }
+  return m_bestRoute;
+}
+
 //! Gets the free space in the players ship
 unsigned int World::getFreeHoldspace() {
   return wrapper->getFreeHoldspace();
@@ -7,8 +7,9 @@
  
 #include <vector>
 #include <string>
-#include <list>
 #include "Structures.h"
+#include "SweepAndPrune.h"
+#include "ShipStates.h"
 
 class MovingObject;
 class Planet;
@@ -25,6 +26,7 @@ class GameObject;
 class Star;
 class Planet;
 class SpaceStation;
+class JobPool;
 
 //! This class represents the game world. 
 /**
@@ -49,7 +51,7 @@ public:
   void deinitialize();
   PlayerObject *getPlayer();
   Star * getStar();
-  std::vector<Planet*> * getPlanets();
+  const std::vector<Planet*> & getPlanets();
   SpaceStation * getStation();
 
   SpaceShip * createNewSpaceShip( ObjectName objectType, float radius );
@@ -58,47 +60,85 @@ public:
   Merchant * createNewMerchant( ObjectName objectType, float radius, Planet *planet, Vector3 aim );
   PoliceShip * createNewPoliceShip( ObjectName objectType, float radius, std::vector<Vector3> point, PlayerObject * player, float maxSpeed );
 
-  std::vector<GraphicsObject*> * getGraphicObjects();
-  std::vector<SpaceShip*> * getSpaceShips();
-  std::vector<ForeignSpaceShip*> * getForeignSpaceShips();
-  std::vector <PoliceShip*> * getPoliceShips();
+  const std::vector<GraphicsObject*> & getGraphicObjects();
+  const std::vector<SpaceShip*> & getSpaceShips();
+  const std::vector<ForeignSpaceShip*> & getForeignSpaceShips();
+  const std::vector<PoliceShip*> & getPoliceShips();
+  ShipHandle getShipHandle( unsigned int index );
+  SpaceShip * getShip( ShipHandle handle );
 
+  void tick( DWORD deltaTime );
+  unsigned long getSimulationTime( void );
+  void interpolateStates( float alpha );
+  void restoreStates( void );
+  void updatePositions( long time );
   void deleteCrashedShips( void );
   void deleteDestroyedShips( void );
+  void castRay( const Vector3 &origin, const Vector3 &direction, float maxDistance, unsigned int ignoreId, std::vector<RayHit> &hits );
+  unsigned int getStationRayId( void );
+  unsigned int getPlayerRayId( void );
 private:
+  void updateRayIndex( void );
+  //! An entry in the ship table. The ship is stored with the type specific pointers used in the typed lists.
+  struct ShipSlot {
+    SpaceShip *ship;
+    ForeignSpaceShip *foreign;  // null, if the ship is not self acting
+    PoliceShip *police;         // null, if the ship is no police ship
+    ShipType type;
+    unsigned int generation;
+    bool removed;
+  };
+  ShipHandle addShip( SpaceShip *ship, ForeignSpaceShip *foreign, PoliceShip *police, ShipType type );
+  void markShipRemoved( unsigned int index );
+  void removeMarkedShips( void );
+  void deleteShip( ShipSlot &slot );
+  Mesh * getMesh( ObjectName objectType );
 
-  std::list<GameObject*> GameObjects;
-  std::list<GameObject*>::iterator playerPosition;
-  std::list<GameObject*>::iterator starPosition;
-  std::list<GameObject*>::iterator stationPosition;
-
-  // these are stored here to be consistent until the new code is completed
-  // contains all objects that are drawable
-  std::vector<GraphicsObject*> m_drawable;          // a list of all drawable objects in the scene
-  // contains all objects that move
-  std::vector<MovingObject*> m_moving;
+  // the objects of the current system. each type is kept in its own array, the pointers in the
+  // arrays are owned by the world and deleted in deinitialize() or if a ship is removed.
+  PlayerObject *m_player;
+  Star *m_star;
+  std::vector<Planet*> m_planets;
+  SpaceStation *m_station;
+  std::vector<GraphicsObject*> m_drawable;          // star, planets and station in drawing order
+  std::vector<SpaceShip*> m_ships;                  // all ships, including missiles
+  std::vector<ShipHandle> m_shipHandles;            // the handle for each ship in m_ships
+  std::vector<ForeignSpaceShip*> m_foreignShips;    // all self acting ships
+  std::vector<PoliceShip*> m_policeShips;
+  std::vector<ShipSlot> m_shipSlots;                // the ship table, indexed by handles
+  std::vector<unsigned int> m_freeShipSlots;
+  std::vector<unsigned int> m_removedShipSlots;
+  SweepAndPrune *m_collisionIndex;                  // broad phase over the station and the ships
+  std::vector<CollisionPair> m_collisionPairs;
+  std::vector<RayHit> m_rayHits;
+  SweepAndPrune *m_rayIndex;                        // the station, the ships and the player for ray queries
+  bool m_rayIndexValid;                             // false, if objects have moved since the index was built
+  ShipStates *m_shipStates;                         // motion state of the ships, gathered in each tick
+  std::vector<ForeignSpaceShip*> m_steeredShips;    // the self acting ship for each ship in m_ships or 0
+  JobPool *m_jobPool;                               // lets the ships decide in parallel
 
+  unsigned long m_simulationTime;                   // milliseconds simulated by tick() in this system
   unsigned long playerStartDistance;
   unsigned int nrForCoriolis[256];
 
   // information about the systems - submitted by wrapper or selfcreated
 public:
   SystemInfo getSystemInfo( void );
-  SystemInfo getSystemInfo( unsigned __int8 number );
+  SystemInfo getSystemInfo( unsigned char number );
   std::string getSystemName( int number );
   std::vector<PlanetInfoGraphical>  * getSystemPlanets( void );
-  std::vector<PlanetInfoGraphical>  * getSystemPlanets( unsigned __int8 number );
-  std::vector<SystemInfo> *getSystems( SystemLists systemList );
-  std::vector<SystemInfo> *getSystems( int left, int right, int bottom, int top );
+  std::vector<PlanetInfoGraphical>  * getSystemPlanets( unsigned char number );
+  std::vector<SystemInfo> *getSystems( SystemLists systemList, bool withDescription = false );
+  std::vector<SystemInfo> *getSystems( int left, int right, int bottom, int top, bool withDescription = false );
   TextureName getSystemStarTexture( void );
-  TextureName getSystemStarTexture( unsigned __int8 number );
+  TextureName getSystemStarTexture( unsigned char number );
   bool isSystemReachable( int number );
   bool isSystemLocal( int number );
-  void World::performJump( int number );
+  void performJump( int number );
 private:
-  TextureName getPlanetTexture( unsigned __int8 number );
+  TextureName getPlanetTexture( unsigned char number );
   TextureName getPlanetTextureR( bool reset );
-  TextureName getStarTexture( unsigned __int8 number );
+  TextureName getStarTexture( unsigned char number );
   TextureName getStarTextureR( void );
   std::vector<PlanetInfoGraphical>  * getSystemPlanetsR( void ); // create randomly an system info
   std::vector<PlanetInfoGraphical> *systemPlanets[256];// array of vectors wich holds the informations about all 256 systems
@@ -123,6 +163,15 @@ public:
   float getMaxFuel();
   bool tradegoodIsInTons(int number);
 
+  std::vector<TradeRoute> * findTradeRoutes( unsigned int hops, unsigned int count, bool perFuel );
+  std::vector<TradeRoute> * findTradeRoutesFromAll( float cash, unsigned int holdspace, unsigned int hops, bool perFuel );
+  const TradeRoute & getBestTradeRoute( void );
+private:
+  TradeRoute m_bestRoute;                           // the result of the last search of getBestTradeRoute()
+  int m_bestRouteSystem;                            // the system, cash and holdspace of the last search
+  float m_bestRouteCash;
+  unsigned int m_bestRouteHoldspace;
+
   // player status
 public:
   PlayerStatus  * getPlayerStatus( void );
@@ -75,11 +75,12 @@ Wrapper::~Wrapper(void)
 //! Get system information
 /**
  * Returns information about the system with the given number
- * the structure 'system' from wrappDef.h is used
+ * the structure 'system' from wrappDef.h is used. The description is
+ * left empty if 'withDescription' is false, which is much faster.
  */
-System Wrapper::getSystemInfo(int number)
+System Wrapper::getSystemInfo(int number, bool withDescription)
 { 
-  System zwSystem = txtgame->getSystemInformation(number);
+  System zwSystem = txtgame->getSystemInformation(number, withDescription);
 
   /* the distance function in textelite divides distances in y-dimension 
   by 2. We decided to divide the y-coordinates of positions by 2 as 
@@ -88,6 +89,27 @@ System Wrapper::getSystemInfo(int number)
   return zwSystem;
   };
 
+//! Get system information of any galaxy
+/**
+ * Returns information about a system of one of the eight galaxies, which are
+ * numbered from 1 to 8. The galaxy does not have to be the current one.
+ */
+System Wrapper::getSystemInfoInGalaxy(int galaxy, int number, bool withDescription)
+{
+  System zwSystem = txtgame->getSystemInformation(galaxy, number, withDescription);
+  zwSystem.posy = zwSystem.posy/2; /* as in getSystemInfo()  */
+  return zwSystem;
+}
+
+//! Get the current galaxy.
+/**
+ * Returns the number of the galaxy we are currently in, from 1 to 8.
+ */
+int Wrapper::getGalaxyNumber()
+{
+  return txtgame->getGalaxyNumber();
+}
+
 //! Get the current system.
 /**
  * Returns the number of the system we are currently in.
@@ -123,8 +145,12 @@ std::vector<int> * Wrapper::getSystemsInRectangle(int left, int right, int botto
   /* if the original y-coordinate was odd, multiplying by 2 will not restore
   the original coordinate. Thus we subtract / add 1 to the y-coordinates
   in a way such that the rectangular is maybe greater, but never smaller
-  than the meant rectangle.  */
-  return txtgame->getSystemsInRectangle(left, right, (bottom-1)*2, (top+1)*2);
+  than the meant rectangle. Negative values would wrap around in the
+  unsigned textelite coordinates, so they are clamped to 0.  */
+  if (right < 0 || top < 0)
+    return new std::vector<int>;
+  return txtgame->getSystemsInRectangle(left < 0 ? 0 : left, right,
+    bottom < 1 ? 0 : (bottom-1)*2, (top+1)*2);
 };
 
 //! Check if a system is reachable.
@@ -292,6 +318,44 @@ unsigned int Wrapper::getCargoBaySize()
 {
   return txtgame->getCargoBaySize();
 }
+
+//! Finds the most profitable trade routes from the current system.
+/**
+ * The current market is known, for all other systems the prices and amounts that are
+ * expected on arrival are used. The routes use the current cash and free holdspace.
+ * \param hops the maximal number of jumps of a route
+ * \param count the maximal number of routes
+ * \param perFuel if true, the routes are ranked by profit per light year instead of profit
+ * \return A pointer to a vector containing the routes, the best first
+ */
+std::vector<TradeRoute> * Wrapper::findTradeRoutes(unsigned int hops, unsigned int count, bool perFuel)
+{
+  return txtgame->findTradeRoutes(hops, count, perFuel);
+}
+
+//! Finds the most profitable trade route from each system of the galaxy.
+/**
+ * All systems use their expected market. This is used to balance the prices.
+ * \param cash the cash at the start of each route
+ * \param holdspace the free holdspace at the start of each route
+ * \param hops the maximal number of jumps of a route
+ * \param perFuel if true, the routes are ranked by profit per light year instead of profit
+ * \return A pointer to a vector containing one route for each system, which has no
+ * jumps if no route gives a profit
+ */
+std::vector<TradeRoute> * Wrapper::findTradeRoutesFromAll(float cash, unsigned int holdspace, unsigned int hops, bool perFuel)
+{
+  return txtgame->findTradeRoutesFromAll((signed long)(cash * 10), holdspace, hops, perFuel);
+}
+
+//! Sets the job pool that divides the trade route search among several threads.
+/**
+ * \param pool the pool, it is not deleted and has to exist as long as routes are searched
+ */
+void Wrapper::setJobPool(JobPool *pool)
+{
+  txtgame->setJobPool(pool);
+}
 //@}
 
 /** @name Actions
@@ -37,7 +37,9 @@ public:
   void addCargoSpace(unsigned int amount);
 
   /************************ * functions: get functions ************************** */
-  System getSystemInfo(int number);
+  System getSystemInfo(int number, bool withDescription = true);
+  System getSystemInfoInGalaxy(int galaxy, int number, bool withDescription = true);
+  int getGalaxyNumber();
   int getCurrentSystem();
   std::vector<int> * getLocalSystems();
   std::vector<int> * getSystemsInRectangle(int left, int right, int bottom, int top);
@@ -57,6 +59,9 @@ public:
   unsigned int getFreeHoldspace();
   float getCurrentCash();
   unsigned int getCargoBaySize();
+  std::vector<TradeRoute> * findTradeRoutes(unsigned int hops, unsigned int count, bool perFuel);
+  std::vector<TradeRoute> * findTradeRoutesFromAll(float cash, unsigned int holdspace, unsigned int hops, bool perFuel);
+  void setJobPool(JobPool *pool);
 
   /*********************** * functions: actions ********************************* */
   void buyFuel(float amount);
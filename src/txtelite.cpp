@@ -24,8 +24,24 @@ and, if necessary, replaced by returning strings
 parser for strings) and replaced by function calls ****************** */
 
 
+#include <string.h>
 #include "txtelite.h"
 
+/*jm the original defines, only used within this file  */
+#define true (-1)
+#define false (0)
+
+#ifndef _MSC_VER
+/*jm strcpy_s is only provided by the microsoft compiler. this replacement is
+used for the headless build on other platforms  */
+template <size_t size>
+static int strcpy_s(char (&dest)[size], const char *src)
+{ strncpy(dest,src,size-1);
+  dest[size-1]='\0';
+  return 0;
+}
+#endif
+
 /*jm****************************** * functions ******************************** */ 
 
 /*jm******** * constructor and destructor for new textEliteGame *************** */
@@ -57,8 +73,14 @@ TextEliteGame::TextEliteGame( void (*vuserErrorFnc)(std::string), void (*vprogEr
 
   for(i=0;i<=lasttrade;i++) strcpy_s(tradnames[i],commodities[i].name);
 
+  /*jm the route search uses the tables of the galaxy, they are filled by buildgalaxy()  */
+  traderoutes.setGalaxy(distances,neighbours);
+  traderoutes.setFuel(maxfuel,fuelcost);
+  for(i=0;i<=lasttrade;i++) traderoutes.setInTons(i,(commodities[i].units)==tons);
+
   mysrand(12345);/* Ensure repeatability  */
 
+  builduniverse();
   galaxynum=1;	buildgalaxy(galaxynum);
 
   currentplanet=numforLave;/* Don't use jump  */
@@ -87,49 +109,48 @@ int TextEliteGame::getCurrentSystem()
 
 /*jm * function returns an int-vector with the numbers of all systems in range  */
 std::vector<int> * TextEliteGame::getLocalSystems()
-{planetnum syscount;
-uint d;
-std::vector<int> * myLocalSystems = new std::vector<int>;
-
-for(syscount=0;syscount<galsize;++syscount)
-{ 	d=distance(galaxy[syscount],galaxy[currentplanet]);
-if(d<=maxfuel)
-{ 	
-  myLocalSystems->push_back(syscount); 
-}
-}
-return myLocalSystems;
+{
+  return new std::vector<int>( neighbours[currentplanet] );
 }
 
 /*jm * function returns an int-vector with the numbers 
-of all systems the given rectangle  */
+of all systems the given rectangle. Only the cells of the grid
+that intersect the rectangle are checked  */
 std::vector<int> * TextEliteGame::getSystemsInRectangle(unsigned int left, 
                                                        unsigned int right, unsigned int bottom, unsigned int top)
-{planetnum syscount;
+{uint cellx,celly,i;
 
 std::vector<int> * mySystems = new std::vector<int>;
 
-if (left < 0) left = 0;
-if (bottom < 0) bottom = 0;
-if (right < 0) right = 0;
-if (top < 0) top = 0;
-
-for(syscount=0;syscount<galsize;++syscount)
-{ 	
-  if( (galaxy[syscount].x >= left)
-    && (galaxy[syscount].x <= right)
-    && (galaxy[syscount].y >= bottom)
-    && (galaxy[syscount].y <= top))
-  {
-    mySystems->push_back(syscount);
+if (left > right || bottom > top) return mySystems;
+
+uint cellLeft = left/gridcellsize;
+uint cellRight = mymin(right/gridcellsize,gridsize-1);
+uint cellBottom = bottom/gridcellsize;
+uint cellTop = mymin(top/gridcellsize,gridsize-1);
+
+for(cellx=cellLeft;cellx<=cellRight;++cellx)
+  for(celly=cellBottom;celly<=cellTop;++celly)
+  { 	std::vector<int> & cell = grid[cellx][celly];
+    for(i=0;i<cell.size();++i)
+    { 	plansys & sys = galaxy[cell[i]];
+      if( (sys.x >= left)
+        && (sys.x <= right)
+        && (sys.y >= bottom)
+        && (sys.y <= top))
+      {
+        mySystems->push_back(cell[i]);
+      }
+    }
   }
-}
 return mySystems;
 }
 
 /*jm**** * function returns information about the system with the given number **
-the structure 'system' from wrappDef.h is used ****************** */
-System TextEliteGame::getSystemInformation(int number)
+the structure 'system' from wrappDef.h is used. The goat soup description
+is only generated if 'withDescription' is set. The complete information is
+cached, so the description is generated only once per galaxy *********** */
+System TextEliteGame::getSystemInformation(int number, bool withDescription)
 {
   System mySystem;
   if (number<0 || number >= galsize) {
@@ -147,7 +168,42 @@ System TextEliteGame::getSystemInformation(int number)
     mySystem.description = "An error occured!";
     return mySystem;
   }
-  plansys mySys = galaxy[number];
+  if (systemcached[number])
+    return systemcache[number];
+  mySystem = makesysteminformation(number, galaxy[number], withDescription);
+  if (withDescription) {
+    systemcache[number] = mySystem;
+    systemcached[number] = true;
+  }
+  return mySystem;
+}
+
+/*jm**** * function returns information about a system of any galaxy, which are
+numbered from 1 to 8. The systems are taken from the universe table, so no
+galaxy has to be generated. The result is not cached ************************ */
+System TextEliteGame::getSystemInformation(uint galaxynumber, int number, bool withDescription)
+{
+  if (galaxynumber < 1 || galaxynumber > galaxycount || number<0 || number >= galsize) {
+    progErrorFnc("The galaxy has to be between 1 and 8 and the system between 0 and 255! Error occured in getSystemInformation(uint galaxynumber, int number, bool withDescription) in txtelite.cpp");
+    System mySystem;
+    mySystem.name = "Error! No System";
+    mySystem.systemnumber = 0;
+    mySystem.description = "An error occured!";
+    return mySystem;
+  }
+  return makesysteminformation(number, unpacksystem(universe.getSystem(galaxynumber-1, number)), withDescription);
+}
+
+/*jm**** * function returns the number of the current galaxy, from 1 to 8 ***** */
+uint TextEliteGame::getGalaxyNumber()
+{
+  return galaxynum;
+}
+
+/*jm**** * fills the structure 'system' from wrappDef.h for a system ********** */
+System TextEliteGame::makesysteminformation(int number, plansys mySys, bool withDescription)
+{
+  System mySystem;
   mySystem.systemnumber = number;
   mySystem.posx = mySys.x;
   mySystem.posy = mySys.y;
@@ -159,8 +215,11 @@ System TextEliteGame::getSystemInformation(int number)
   mySystem.productivity = mySys.productivity;
   mySystem.radius = mySys.radius;
 
-  rnd_seed = mySys.goatsoupseed;
-  mySystem.description = goat_soup("\x8F is \x97.",&mySys);
+  if (withDescription) {
+    rnd_seed = mySys.goatsoupseed;
+    mySystem.description.reserve(128);
+    goat_soup("\x8F is \x97.",&mySys,mySystem.description);
+  }
 
   return mySystem;
 }
@@ -169,7 +228,7 @@ System TextEliteGame::getSystemInformation(int number)
 system with the current fuel ********************************** */
 bool TextEliteGame::systemIsReachable(int number)
 {
-  uint d=distance(galaxy[number],galaxy[currentplanet]);
+  uint d=distances[number][currentplanet];
   return (d <= fuel);
 }
 
@@ -177,7 +236,7 @@ bool TextEliteGame::systemIsReachable(int number)
 system if we have maximal amount of fuel **************************** */
 bool TextEliteGame::systemIsInLocalRange(int number)
 {
-  uint d=distance(galaxy[number],galaxy[currentplanet]);
+  uint d=distances[number][currentplanet];
   return (d <= maxfuel);
 }
 
@@ -259,6 +318,37 @@ bool TextEliteGame::tradegoodIsInTons(int number)
   return ((commodities[number].units)==tons);
 }
 
+/*jm*** * Finds the most profitable routes of up to 'hops' jumps starting at the
+current system. The exact market of the current system and the expected markets
+of all other systems are used, as well as the cash and the free holdspace. If
+'perFuel' is true, the routes are ranked by their profit per light year ** */
+std::vector<TradeRoute> * TextEliteGame::findTradeRoutes(uint hops, uint count, bool perFuel)
+{
+  if (!traderoutesbuilt) buildtraderoutes();
+  TradeRoutes::Market market;
+  for (int i=0; i < lasttrade + 1; i++)
+  {
+    market.price[i] = localmarket.price[i];
+    market.quantity[i] = localmarket.quantity[i];
+  }
+  return traderoutes.find(currentplanet, market, cash, holdspace, hops, count, perFuel);
+}
+
+/*jm*** * Finds the best route from each system of the galaxy for a given cash
+and holdspace, all systems use their expected market. Used for balancing *** */
+std::vector<TradeRoute> * TextEliteGame::findTradeRoutesFromAll(int32 cash, uint holdspace, uint hops, bool perFuel)
+{
+  if (!traderoutesbuilt) buildtraderoutes();
+  return traderoutes.findFromAll(cash, holdspace, hops, perFuel);
+}
+
+/*jm*** * Sets the job pool that the trade route search uses, it is owned by the
+world. Without a pool the routes are searched in the calling thread ********** */
+void TextEliteGame::setJobPool(JobPool *pool)
+{
+  traderoutes.setJobPool(pool);
+}
+
 
 /*jm****************************************************************************
 ******************** * new functions: actions ***********************************
@@ -303,11 +393,11 @@ void TextEliteGame::setCargoBay(uint amount)
 In case of errors the error functions are called ******************** */
 void TextEliteGame::performJump(int number)
 {
-  if (number < 0 || number > galsize)
+  if (number < 0 || number >= galsize)
   { 
 	progErrorFnc("The integer in 'number' has to be between 0 and 256! Error occured in performJump(int number) in txtelite.cpp"); return; };
 
-  uint d=distance(galaxy[number],galaxy[currentplanet]);
+  uint d=distances[number][currentplanet];
 
   if (d>maxfuel) 
   { 
@@ -847,13 +937,118 @@ void TextEliteGame::nextgalaxy(seedtype *s) /* Apply to base seed; once for gala
   (*s).w2 = twist((*s).w2);
 }
 
-/* Original game generated from scratch each time info needed  */
-void TextEliteGame::buildgalaxy(uint galaxynum)
+/*jm*** * Fills the universe table with the systems of all galaxies. The table
+is mapped from the cache file if the file was written from the same seeds.
+Otherwise all galaxies are generated with makesystem() as in the original code
+and the file is written for the next start ********************************* */
+void TextEliteGame::builduniverse(void)
 {	uint syscount,galcount;
   seed.w0=base0; seed.w1=base1; seed.w2=base2; /* Initialise seed for galaxy 1  */
-  for(galcount=1;galcount<galaxynum;++galcount) nextgalaxy(&seed);
+  for(galcount=0;galcount<galaxycount;++galcount)
+  { galaxyseeds[galcount][0]=seed.w0;
+    galaxyseeds[galcount][1]=seed.w1;
+    galaxyseeds[galcount][2]=seed.w2;
+    nextgalaxy(&seed);
+  }
+  if(universe.load(universefile,galaxyseeds)) return;
+
+  universe.create(galaxyseeds);
+  for(galcount=0;galcount<galaxycount;++galcount)
+  { seed.w0=galaxyseeds[galcount][0];
+    seed.w1=galaxyseeds[galcount][1];
+    seed.w2=galaxyseeds[galcount][2];
+    for(syscount=0;syscount<galsize;++syscount)
+    { plansys p=makesystem(&seed);
+      UniverseSystem s;
+      s.x=(uint8)p.x; s.y=(uint8)p.y;
+      s.economy=(uint8)p.economy; s.govtype=(uint8)p.govtype;
+      s.techlev=(uint8)p.techlev; s.population=(uint8)p.population;
+      s.productivity=(uint16)p.productivity; s.radius=(uint16)p.radius;
+      s.goatsoupseed[0]=p.goatsoupseed.a; s.goatsoupseed[1]=p.goatsoupseed.b;
+      s.goatsoupseed[2]=p.goatsoupseed.c; s.goatsoupseed[3]=p.goatsoupseed.d;
+      s.nameOffset=0;
+      universe.add(s,p.name);
+    }
+  }
+  universe.save(universefile); /* without the file the table is generated again at the next start  */
+}
+
+/*jm*** * Converts a system of the universe table back into the original structure */
+plansys TextEliteGame::unpacksystem(const UniverseSystem & s)
+{	plansys p;
+  p.x=s.x; p.y=s.y;
+  p.economy=s.economy; p.govtype=s.govtype;
+  p.techlev=s.techlev; p.population=s.population;
+  p.productivity=s.productivity; p.radius=s.radius;
+  p.goatsoupseed.a=s.goatsoupseed[0]; p.goatsoupseed.b=s.goatsoupseed[1];
+  p.goatsoupseed.c=s.goatsoupseed[2]; p.goatsoupseed.d=s.goatsoupseed[3];
+  strcpy_s(p.name,universe.getName(s));
+  return p;
+}
+
+/*jm Original game generated from scratch each time info needed. The systems
+are now taken from the universe table, so no seed has to be tweaked  */
+void TextEliteGame::buildgalaxy(uint galaxynum)
+{	uint syscount;
   /* Put galaxy data into array of structures  */
-  for(syscount=0;syscount<galsize;++syscount) galaxy[syscount]=makesystem(&seed);
+  for(syscount=0;syscount<galsize;++syscount) galaxy[syscount]=unpacksystem(universe.getSystem(galaxynum-1,syscount));
+  builddistances();
+  buildgrid();
+  for(syscount=0;syscount<galsize;++syscount) systemcached[syscount]=false;
+  traderoutesbuilt=false;
+}
+
+/*jm*** * Fills the distance table and the neighbour lists of the current galaxy.
+The values are computed with distance(), so they are the same as in the original
+code. The distance is symmetric, so each pair is computed only once ******** */
+void TextEliteGame::builddistances(void)
+{	uint i,j;
+  for(i=0;i<galsize;++i)
+  { distances[i][i]=0;
+    for(j=i+1;j<galsize;++j)
+    { distances[i][j]=distances[j][i]=(uint16)distance(galaxy[i],galaxy[j]);
+    }
+  }
+  for(i=0;i<galsize;++i)
+  { neighbours[i].clear();
+    for(j=0;j<galsize;++j)
+      if(distances[i][j]<=maxfuel) neighbours[i].push_back(j);
+  }
+}
+
+/*jm*** * Sorts the systems of the current galaxy into the cells of the grid
+used by getSystemsInRectangle() ************************************* */
+void TextEliteGame::buildgrid(void)
+{	uint syscount,cellx,celly;
+  for(cellx=0;cellx<gridsize;++cellx)
+    for(celly=0;celly<gridsize;++celly) grid[cellx][celly].clear();
+  for(syscount=0;syscount<galsize;++syscount)
+    grid[galaxy[syscount].x/gridcellsize][galaxy[syscount].y/gridcellsize].push_back(syscount);
+}
+
+/*jm*** * Computes the expected market of each system for the route search. The
+fluctuation is drawn on arrival, so the prices and amounts are averaged over
+all 256 values using genmarket() ****************************************** */
+void TextEliteGame::buildtraderoutes(void)
+{	uint syscount,fluct,i;
+  for(syscount=0;syscount<galsize;++syscount)
+  { uint price[lasttrade+1],quantity[lasttrade+1];
+    for(i=0;i<=lasttrade;++i) price[i]=quantity[i]=0;
+    for(fluct=0;fluct<256;++fluct)
+    { markettype market=genmarket(fluct,galaxy[syscount]);
+      for(i=0;i<=lasttrade;++i)
+      { price[i]+=market.price[i];
+        quantity[i]+=market.quantity[i];
+      }
+    }
+    TradeRoutes::Market expected;
+    for(i=0;i<=lasttrade;++i)
+    { expected.price[i]=(price[i]+128)/256;
+      expected.quantity[i]=quantity[i]/256; /* rounded down, so the amounts are rather available  */
+    }
+    traderoutes.setMarket(syscount,expected);
+  }
+  traderoutesbuilt=true;
 }
 
 /**-Functions for navigation * */
@@ -867,6 +1062,8 @@ uint TextEliteGame::distance(plansys a,plansys b)
 myboolean TextEliteGame::dogalhyp(char *s) /* Jump to next galaxy  */
 /* Preserve planetnum (eg. if leave 7th planet
 arrive at 7th planet)  */
+/*jm the systems are taken from the universe table, only the distances
+and the grid of the new galaxy are computed  */
 {	(void)(&s);/* Discard s  */
 galaxynum++;
 if(galaxynum==9) {galaxynum=1;}
@@ -898,7 +1095,8 @@ rnd_seed.d = x;
 return a;
 }
 
-std::string TextEliteGame::goat_soup(const char *source,plansys  * psy)
+/*jm the description is appended to 'result' instead of returning temporary strings  */
+void TextEliteGame::goat_soup(const char *source,plansys  * psy,std::string & result)
 {
   static struct desc_choice desc_list[] =
   {
@@ -941,8 +1139,6 @@ std::string TextEliteGame::goat_soup(const char *source,plansys  * psy)
   };
   char pairs0[]="ABOUSEITILETSTONLONUTHNO";
 
-  std::string result = ""; /**jm added to get output into a variable instead of using printf  */
-
   /* must continue into ..  */
   for(;;)
   {	uint8 c=*(source++);
@@ -953,7 +1149,7 @@ std::string TextEliteGame::goat_soup(const char *source,plansys  * psy)
   else
   {	if (c <=0xA4)
   {	int rnd = gen_rnd_number();
-  result += goat_soup(desc_list[c-0x81].option[(rnd >= 0x33)+(rnd >= 0x66)+(rnd >= 0x99)+(rnd >= 0xCC)],psy);
+  goat_soup(desc_list[c-0x81].option[(rnd >= 0x33)+(rnd >= 0x66)+(rnd >= 0x99)+(rnd >= 0xCC)],psy,result);
   }
   else switch(c)
   { case 0xB0: /* planet name  */
@@ -991,11 +1187,10 @@ std::string TextEliteGame::goat_soup(const char *source,plansys  * psy)
           }
           }
           }	break;
-        default: return "<bad char in data [%X]>";
+        default: result += "<bad char in data [%X]>"; return;
   }	/* endswitch  */
   }	/* endelse  */
   }	/* endwhile  */
-  return result;
 }	/* endfunc  */
 
 /**+end * */
@@ -57,6 +57,8 @@ of Elite with no combat or missions.
 #include <string>
 #include <vector>
 #include "wrappDef.h"
+#include "TradeRoutes.h"
+#include "Universe.h"
 
 /*jm***************** * original includes ************************************* */
 //#include <stdlib.h>
@@ -67,13 +69,17 @@ of Elite with no combat or missions.
 #include <math.h>
 
 /*jm***************** * original defines ************************************** */
-#define true (-1)
-#define false (0)
+/*jm the original defines of true and false are in txtelite.cpp, so they do not
+change headers that are included after this file  */
 #define tons (0)
 
 #define maxlen (20) /* Length of strings  */
 
 #define galsize (256)
+#define galaxycount (8)
+#define universefile "universe.cache" /*jm cache file of the systems of all galaxies  */
+#define gridcellsize (32) /*jm edge length of a cell of the system grid  */
+#define gridsize (256/gridcellsize) /*jm number of cells per row of the grid  */
 #define AlienItems (16)
 #define lasttrade AlienItems
 
@@ -151,6 +157,23 @@ private:
   /*jm********** * original variables ******************************************* */
 
   plansys galaxy[galsize]; /* Need 0 to galsize-1 inclusive  */
+  /*jm the systems of all galaxies, generated or loaded by builduniverse()  */
+  Universe universe;
+  uint16 galaxyseeds[galaxycount][3];
+  /*jm distances between all systems of the galaxy, filled by buildgalaxy()  */
+  uint16 distances[galsize][galsize];
+  /*jm for each system all systems within maxfuel, ordered by number  */
+  std::vector<int> neighbours[galsize];
+  /*jm the systems bucketed by their position, filled by buildgalaxy()  */
+  std::vector<int> grid[gridsize][gridsize];
+  /*jm complete system information including the description, filled on
+  first request and cleared by buildgalaxy()  */
+  System systemcache[galsize];
+  bool systemcached[galsize];
+  /*jm the route search with the expected markets of all systems, the markets
+  are computed on the first search and cleared by buildgalaxy()  */
+  TradeRoutes traderoutes;
+  bool traderoutesbuilt;
   seedtype seed;
   fastseedtype rnd_seed;
   myboolean nativerand;
@@ -203,7 +226,9 @@ public:
   std::vector<int> * getLocalSystems();
   std::vector<int> * getSystemsInRectangle(unsigned int left, 
     unsigned int right, unsigned int bottom, unsigned int top);
-  System getSystemInformation(int number);
+  System getSystemInformation(int number, bool withDescription = true);
+  System getSystemInformation(uint galaxynumber, int number, bool withDescription);
+  uint getGalaxyNumber();
 
   bool systemIsReachable(int number);
   bool systemIsInLocalRange(int number);
@@ -222,6 +247,10 @@ public:
   int getFuelCost();
   bool tradegoodIsInTons(int number);
 
+  std::vector<TradeRoute> * findTradeRoutes(uint hops, uint count, bool perFuel);
+  std::vector<TradeRoute> * findTradeRoutesFromAll(int32 cash, uint holdspace, uint hops, bool perFuel);
+  void setJobPool(JobPool *pool);
+
   /*jm**************** * new functions: actions ********************************* */
   void performJump(int number);
 
@@ -255,11 +284,17 @@ private:
   uint16 rotatel(uint16 x);
   uint16 twist(uint16 x);
   void nextgalaxy(seedtype *s);
+  void builduniverse(void);
+  plansys unpacksystem(const UniverseSystem & s);
+  System makesysteminformation(int number, plansys p, bool withDescription);
   void buildgalaxy(uint galaxynum);
+  void builddistances(void);
+  void buildgrid(void);
+  void buildtraderoutes(void);
   uint distance(plansys a,plansys b);
   myboolean dogalhyp(char *s);
   int gen_rnd_number (void);
-  std::string goat_soup(const char *source,plansys  * psy);
+  void goat_soup(const char *source,plansys  * psy,std::string & result);
 
 };
 
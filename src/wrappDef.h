@@ -7,6 +7,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 /** Different types of governments  */
 enum govTypes {
@@ -61,3 +62,22 @@ struct Tradegood {
   std::string name;
   std::string unit;
 };
+
+/** One jump of a trade route and the good that is carried  */
+struct TradeLeg {
+  unsigned int from;
+  unsigned int to;
+  float distance; // in light years
+  int good;       // -1 if no good gives a profit
+  unsigned int amount;
+  float profit;   // in credits, the fuel is already paid
+};
+
+/** A route of several jumps found by the trade route search  */
+struct TradeRoute {
+  TradeRoute() : profit(0), distance(0) {}
+
+  std::vector<TradeLeg> legs;
+  float profit;   // in credits
+  float distance; // in light years, the fuel needed
+};